@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Аллокатор, выравнивающий каждый блок по границе Alignment байт (например, 32 для AVX2 или 64 — размер строки кэша).
+// Размер блока округляется вверх до кратного Alignment, поэтому блок занимает строки кэша целиком и не делит
+// их с соседними выделениями: векторы разных потоков не мешают друг другу ложным разделением (false sharing).
+// reallocate нет: realloc не сохраняет выравнивание, поэтому рост всегда идёт через новый выровненный блок.
+// Гарантированное выравнивание доступно на этапе компиляции как AlignedAllocator::alignment
+// (и как ArrayPtr::kAlignment / SimpleVector::kAlignment)
+template <typename Type, size_t Alignment>
+class AlignedAllocator {
+	static_assert(Alignment != 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+	static_assert(Alignment >= alignof(Type), "Alignment must not be weaker than the alignment of Type");
+
+public:
+	using value_type = Type;
+
+	static constexpr size_t alignment = Alignment;
+
+	template <typename Other>
+	struct rebind {
+		using other = AlignedAllocator<Other, Alignment>;
+	};
+
+	AlignedAllocator() noexcept = default;
+
+	template <typename Other>
+	AlignedAllocator(const AlignedAllocator<Other, Alignment>&) noexcept {
+	}
+
+	Type* allocate(size_t size) {
+		return static_cast<Type*>(::operator new(ByteSize(size), std::align_val_t(Alignment)));
+	}
+
+	void deallocate(Type* raw_ptr, size_t size) noexcept {
+		::operator delete(static_cast<void*>(raw_ptr), ByteSize(size), std::align_val_t(Alignment));
+	}
+
+private:
+	static size_t ByteSize(size_t size) {
+		if (size > (static_cast<size_t>(-1) - Alignment) / sizeof(Type)) {
+			throw std::bad_array_new_length();
+		}
+		return (size * sizeof(Type) + Alignment - 1) & ~(Alignment - 1);
+	}
+};
+
+template <typename Type, typename Other, size_t Alignment>
+inline bool operator==(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&) noexcept {
+	return true;
+}
+
+template <typename Type, typename Other, size_t Alignment>
+inline bool operator!=(const AlignedAllocator<Type, Alignment>&, const AlignedAllocator<Other, Alignment>&) noexcept {
+	return false;
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+// Монотонная арена для короткоживущих векторов (например, на время одного запроса).
+// Память выдаётся сдвигом указателя внутри больших кусков (chunk), освобождение отдельных блоков ничего не делает:
+// при росте вектора старый блок просто остаётся в арене. Reset() за O(1) возвращает арену в начало,
+// сохраняя все куски, поэтому следующий запрос того же объёма вовсе не обращается к malloc.
+// Память возвращается системе только в Release() и в деструкторе.
+// Арена не потокобезопасна: у каждого потока или запроса должна быть своя
+class Arena {
+public:
+	static constexpr size_t kDefaultChunkSize = size_t(64) << 10;
+	static constexpr size_t kMaxChunkSize = size_t(16) << 20;
+
+	// chunk_size — размер первого куска. Следующие вдвое больше предыдущих, но не больше kMaxChunkSize
+	explicit Arena(size_t chunk_size = kDefaultChunkSize) noexcept
+		: next_chunk_size_(std::max<size_t>(chunk_size, 64)) {
+	}
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	~Arena() {
+		Release();
+	}
+
+	// Выделяет bytes байт с выравниванием alignment (степень двойки)
+	void* Allocate(size_t bytes, size_t alignment) {
+		assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+		if (void* ptr = Bump(bytes, alignment)) {
+			return ptr;
+		}
+		// Дальше в цепочке могут быть куски, сохранённые Reset(); слишком маленькие пропускаются
+		while (current_ != nullptr && current_->next != nullptr) {
+			Enter(current_->next);
+			if (void* ptr = Bump(bytes, alignment)) {
+				return ptr;
+			}
+		}
+		if (bytes > static_cast<size_t>(-1) - alignment) {
+			throw std::bad_alloc();
+		}
+		AddChunk(bytes + alignment);
+		return Bump(bytes, alignment);
+	}
+
+	// Расширяет или сужает на месте блок ptr, если он выделен последним. Возвращает false, если это невозможно
+	bool TryResize(void* ptr, size_t old_bytes, size_t new_bytes) noexcept {
+		char* block = static_cast<char*>(ptr);
+		if (block + old_bytes != cursor_ || new_bytes > static_cast<size_t>(limit_ - block)) {
+			return false;
+		}
+		cursor_ = block + new_bytes;
+		bytes_used_ = bytes_used_ - old_bytes + new_bytes;
+		return true;
+	}
+
+	// Забывает все выделенные блоки за O(1). Куски остаются и используются заново
+	void Reset() noexcept {
+		if (first_ != nullptr) {
+			Enter(first_);
+		}
+		bytes_used_ = 0;
+	}
+
+	// Возвращает все куски системе
+	void Release() noexcept {
+		while (first_ != nullptr) {
+			Chunk* next = first_->next;
+			::operator delete(static_cast<void*>(first_));
+			first_ = next;
+		}
+		current_ = nullptr;
+		cursor_ = nullptr;
+		limit_ = nullptr;
+		bytes_used_ = 0;
+	}
+
+	// Сколько байт выдано с последнего Reset(), не считая выравнивания
+	size_t GetBytesUsed() const noexcept {
+		return bytes_used_;
+	}
+
+	// Сколько раз арена выделяла кусок у системы за всё время жизни
+	size_t GetChunkAllocations() const noexcept {
+		return chunk_allocations_;
+	}
+
+private:
+	struct Chunk {
+		Chunk* next;
+		size_t size;
+	};
+
+	// Данные куска начинаются сразу за заголовком, выровненным как max_align_t
+	static constexpr size_t kHeaderSize = (sizeof(Chunk) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+	Chunk* first_ = nullptr;
+	Chunk* current_ = nullptr;
+	char* cursor_ = nullptr;
+	char* limit_ = nullptr;
+	size_t next_chunk_size_;
+	size_t bytes_used_ = 0;
+	size_t chunk_allocations_ = 0;
+
+	void* Bump(size_t bytes, size_t alignment) noexcept {
+		if (cursor_ == nullptr) {
+			return nullptr;
+		}
+		const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(cursor_);
+		const size_t padding = static_cast<size_t>(((address + alignment - 1) & ~(std::uintptr_t(alignment) - 1)) - address);
+		if (padding > static_cast<size_t>(limit_ - cursor_) || bytes > static_cast<size_t>(limit_ - cursor_) - padding) {
+			return nullptr;
+		}
+		char* ptr = cursor_ + padding;
+		cursor_ = ptr + bytes;
+		bytes_used_ += bytes;
+		return ptr;
+	}
+
+	void Enter(Chunk* chunk) noexcept {
+		current_ = chunk;
+		cursor_ = reinterpret_cast<char*>(chunk) + kHeaderSize;
+		limit_ = cursor_ + chunk->size;
+	}
+
+	// Добавляет кусок не меньше min_size байт в конец цепочки и делает его текущим
+	void AddChunk(size_t min_size) {
+		const size_t size = std::max(next_chunk_size_, min_size);
+		if (size > static_cast<size_t>(-1) - kHeaderSize) {
+			throw std::bad_alloc();
+		}
+		Chunk* chunk = static_cast<Chunk*>(::operator new(kHeaderSize + size));
+		chunk->next = nullptr;
+		chunk->size = size;
+		++chunk_allocations_;
+		next_chunk_size_ = std::min(next_chunk_size_ * 2, kMaxChunkSize);
+		if (current_ != nullptr) {
+			current_->next = chunk;
+		}
+		else {
+			first_ = chunk;
+		}
+		Enter(chunk);
+	}
+};
+
+// Аллокатор SimpleVector, берущий память из Arena. deallocate ничего не делает: память освобождается
+// вместе с ареной. reallocate расширяет последний выделенный блок на месте, поэтому тривиально перемещаемые
+// элементы вектора, растущего последним, вообще не копируются. Арена должна жить дольше векторов
+template <typename Type>
+class ArenaAllocator {
+public:
+	using value_type = Type;
+
+	ArenaAllocator(Arena& arena) noexcept
+		: arena_(&arena) {
+	}
+
+	template <typename Other>
+	ArenaAllocator(const ArenaAllocator<Other>& other) noexcept
+		: arena_(&other.GetArena()) {
+	}
+
+	Type* allocate(size_t size) {
+		return static_cast<Type*>(arena_->Allocate(ByteSize(size), alignof(Type)));
+	}
+
+	void deallocate(Type*, size_t) noexcept {
+	}
+
+	// Переносит блок в память под new_size элементов, сохраняя содержимое побайтно
+	Type* reallocate(Type* raw_ptr, size_t old_size, size_t new_size) {
+		if (arena_->TryResize(raw_ptr, ByteSize(old_size), ByteSize(new_size))) {
+			return raw_ptr;
+		}
+		Type* new_ptr = allocate(new_size);
+		std::memcpy(static_cast<void*>(new_ptr), static_cast<const void*>(raw_ptr), std::min(old_size, new_size) * sizeof(Type));
+		return new_ptr;
+	}
+
+	Arena& GetArena() const noexcept {
+		return *arena_;
+	}
+
+private:
+	Arena* arena_;
+
+	static size_t ByteSize(size_t size) {
+		if (size > static_cast<size_t>(-1) / sizeof(Type)) {
+			throw std::bad_array_new_length();
+		}
+		return size * sizeof(Type);
+	}
+};
+
+template <typename Type, typename Other>
+inline bool operator==(const ArenaAllocator<Type>& lhs, const ArenaAllocator<Other>& rhs) noexcept {
+	return &lhs.GetArena() == &rhs.GetArena();
+}
+
+template <typename Type, typename Other>
+inline bool operator!=(const ArenaAllocator<Type>& lhs, const ArenaAllocator<Other>& rhs) noexcept {
+	return !(lhs == rhs);
+}
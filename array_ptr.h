@@ -1,75 +1,255 @@
+#pragma once
+
+#include "constexpr_support.h"
+#include "vector_stats.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 #include <utility>
 
+// Тривиально перемещаемый тип можно перенести в другую память побайтовым копированием,
+// не вызывая конструктор перемещения и деструктор исходного объекта.
+// Свои типы-дескрипторы можно пометить специализацией этого шаблона
+template <typename Type>
+struct is_trivially_relocatable : std::is_trivially_copyable<Type> {
+};
+
+template <typename Type>
+struct is_trivially_relocatable<std::unique_ptr<Type>> : std::true_type {
+};
+
 template <typename Type>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<Type>::value;
+
+// Побайтно переносит count тривиально перемещаемых объектов из src в dest; области могут перекрываться (memmove).
+// На этапе компиляции байты копировать нельзя, и объекты там — а это тривиально копируемые типы — копируются
+// через промежуточный буфер
+template <typename Type>
+SIMPLE_VECTOR_CONSTEXPR void RelocateBytes(Type* dest, const Type* src, size_t count) noexcept {
+	if (count == 0) {
+		return;
+	}
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+	if (std::is_constant_evaluated()) {
+		if constexpr (std::is_trivially_copyable_v<Type>) {
+			std::allocator<Type> alloc;
+			Type* buffer = alloc.allocate(count);
+			for (size_t i = 0; i < count; ++i) {
+				std::construct_at(buffer + i, src[i]);
+			}
+			for (size_t i = 0; i < count; ++i) {
+				std::construct_at(dest + i, buffer[i]);
+			}
+			alloc.deallocate(buffer, count);
+		}
+		return;
+	}
+#endif
+	std::memmove(static_cast<void*>(dest), static_cast<const void*>(src), count * sizeof(Type));
+}
+
+// Есть ли у аллокатора метод reallocate(p, old_size, new_size), расширяющий блок с сохранением содержимого
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {
+};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+	std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t{}, size_t{}))>> : std::true_type {
+};
+
+// Гарантированное выравнивание блоков аллокатора Alloc в байтах: Alloc::alignment, если аллокатор его объявляет
+// (см. AlignedAllocator), иначе alignof элемента
+template <typename Alloc, typename = void>
+struct AllocatorAlignment
+	: std::integral_constant<size_t, alignof(typename std::allocator_traits<Alloc>::value_type)> {
+};
+
+template <typename Alloc>
+struct AllocatorAlignment<Alloc, std::void_t<decltype(Alloc::alignment)>>
+	: std::integral_constant<size_t, Alloc::alignment> {
+};
+
+// Владеет сырым (неинициализированным) блоком памяти под size элементов типа Type, полученным от аллокатора Alloc.
+// ArrayPtr не конструирует и не разрушает элементы: за время жизни объектов в блоке отвечает владелец
+template <typename Type, typename Alloc = std::allocator<Type>>
 class ArrayPtr {
+	using AllocTraits = std::allocator_traits<Alloc>;
+	static_assert(std::is_same_v<typename AllocTraits::value_type, Type>, "Alloc::value_type must be Type");
+	static_assert(std::is_same_v<typename AllocTraits::pointer, Type*>, "Alloc must use raw pointers");
+
 public:
-	//  ArrayPtr  
+	// Выравнивание начала блока, известное на этапе компиляции
+	static constexpr size_t kAlignment = AllocatorAlignment<Alloc>::value;
+
+	// Инициализирует ArrayPtr нулевым указателем
 	ArrayPtr() = default;
 
-	//      size   Type.  size == 0,  raw_ptr_    nullptr
-	explicit ArrayPtr(size_t size) {
+	SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(const Alloc& alloc) noexcept
+		: alloc_(alloc) {
+	}
+
+	// Выделяет сырую память под size элементов типа Type, не вызывая конструкторов.
+	// Если size == 0, поле raw_ptr_ должно быть равно nullptr
+	SIMPLE_VECTOR_CONSTEXPR explicit ArrayPtr(size_t size, const Alloc& alloc = Alloc())
+		: alloc_(alloc) {
 		if (size != 0) {
-			Type* arr = new Type[size]{};
-			raw_ptr_ = arr;
+			raw_ptr_ = AllocTraits::allocate(alloc_, size);
+			size_ = size;
+			assert(IsAligned(raw_ptr_));
+			CountAllocation(size);
 		}
 	}
 
-	//    ,       nullptr
-	explicit ArrayPtr(Type* raw_ptr) noexcept {
+	// Конструктор из сырого указателя на блок, выделенный аллокатором alloc под size элементов, либо nullptr
+	SIMPLE_VECTOR_CONSTEXPR ArrayPtr(Type* raw_ptr, size_t size, const Alloc& alloc = Alloc()) noexcept
+		: alloc_(alloc) {
 		raw_ptr_ = raw_ptr;
+		size_ = raw_ptr != nullptr ? size : 0;
 	}
 
-	//  
+	// Запрещаем копирование
 	ArrayPtr(const ArrayPtr&) = delete;
 
-	ArrayPtr(ArrayPtr&& other) {
+	SIMPLE_VECTOR_CONSTEXPR ArrayPtr(ArrayPtr&& other) noexcept
+		: alloc_(std::move(other.alloc_)) {
 		raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+		size_ = std::exchange(other.size_, 0);
 	}
 
-	//  
+	// Запрещаем присваивание
 	ArrayPtr& operator=(const ArrayPtr&) = delete;
 
-	ArrayPtr& operator=(ArrayPtr&& other) {
-		raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+	// Забирает блок other. Аллокаторы должны быть равны: сам аллокатор не переприсваивается
+	SIMPLE_VECTOR_CONSTEXPR ArrayPtr& operator=(ArrayPtr&& other) noexcept {
+		if (this != &other) {
+			assert(alloc_ == other.alloc_);
+			Deallocate();
+			raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+			size_ = std::exchange(other.size_, 0);
+		}
 		return *this;
 	}
 
-	~ArrayPtr() {
-		delete[]raw_ptr_;
+	// Освобождает память. Элементы к этому моменту должны быть разрушены владельцем
+	SIMPLE_VECTOR_CONSTEXPR ~ArrayPtr() {
+		Deallocate();
 	}
 
-	//     ,    .        
-	[[nodiscard]] Type* Release() noexcept {
+	// Прекращает владением массивом в памяти, возвращает значение адреса массива. После вызова метода указатель на массив должен обнулиться
+	[[nodiscard]] SIMPLE_VECTOR_CONSTEXPR Type* Release() noexcept {
 		Type* temp = raw_ptr_;
 		raw_ptr_ = nullptr;
+		size_ = 0;
 		return temp;
 	}
 
-	//        index
-	Type& operator[](size_t index) noexcept {
+	// Возвращает ссылку на элемент массива с индексом index
+	SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
 		return raw_ptr_[index];
 	}
 
-	//         index
-	const Type& operator[](size_t index) const noexcept {
+	// Возвращает константную ссылку на элемент массива с индексом index
+	SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
 		return raw_ptr_[index];
 	}
 
-	//  true,   ,  false   
-	explicit operator bool() const {
+	// Возвращает true, если указатель ненулевой, и false в противном случае
+	SIMPLE_VECTOR_CONSTEXPR explicit operator bool() const {
 		return raw_ptr_ != nullptr;
 	}
 
-	//    ,    
-	Type* Get() const noexcept {
+	// Возвращает значение сырого указателя, хранящего адрес начала массива
+	SIMPLE_VECTOR_CONSTEXPR Type* Get() const noexcept {
 		return raw_ptr_;
 	}
 
-	//        other
-	void swap(ArrayPtr& other) noexcept {
+	// Возвращает количество элементов, под которое выделен блок
+	SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	// Возвращает аллокатор, которым выделен блок
+	SIMPLE_VECTOR_CONSTEXPR Alloc& GetAllocator() noexcept {
+		return alloc_;
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR const Alloc& GetAllocator() const noexcept {
+		return alloc_;
+	}
+
+	// Переносит блок в память под new_size элементов побайтовым копированием первых live_count элементов.
+	// Если аллокатор умеет reallocate, блок расширяется на месте. Допустимо только для тривиально
+	// перемещаемых типов: объекты не разрушаются и не конструируются, а просто меняют адрес
+	SIMPLE_VECTOR_CONSTEXPR void Relocate(size_t new_size, size_t live_count) {
+		assert(live_count <= size_ && live_count <= new_size);
+		if constexpr (HasReallocate<Alloc>::value) {
+			if (raw_ptr_ != nullptr && new_size != 0 && !IsConstantEvaluated()) {
+				raw_ptr_ = alloc_.reallocate(raw_ptr_, size_, new_size);
+				size_ = new_size;
+				assert(IsAligned(raw_ptr_));
+				CountAllocation(new_size);
+				CountDeallocation();
+				return;
+			}
+		}
+		ArrayPtr temp(new_size, alloc_);
+		RelocateBytes(temp.raw_ptr_, raw_ptr_, live_count);
+		swap(temp);
+	}
+
+	// Обменивается значениям указателя на массив с объектом other.
+	// Аллокаторы не обмениваются: они должны быть равны либо обмениваться отдельно через SwapAllocator
+	SIMPLE_VECTOR_CONSTEXPR void swap(ArrayPtr& other) noexcept {
 		std::swap(raw_ptr_, other.raw_ptr_);
+		std::swap(size_, other.size_);
+	}
+
+	// Обменивается аллокаторами с other
+	SIMPLE_VECTOR_CONSTEXPR void SwapAllocator(ArrayPtr& other) noexcept {
+		using std::swap;
+		swap(alloc_, other.alloc_);
 	}
 
 private:
+	Alloc alloc_;
 	Type* raw_ptr_ = nullptr;
-};
\ No newline at end of file
+	size_t size_ = 0;
+
+	SIMPLE_VECTOR_CONSTEXPR static bool IsAligned(const Type* raw_ptr) noexcept {
+		if (IsConstantEvaluated()) {
+			return true;
+		}
+		return reinterpret_cast<std::uintptr_t>(raw_ptr) % kAlignment == 0;
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void Deallocate() noexcept {
+		if (raw_ptr_ != nullptr) {
+			AllocTraits::deallocate(alloc_, raw_ptr_, size_);
+			CountDeallocation();
+		}
+	}
+
+	// Сводные счётчики потока (см. vector_stats.h). reallocate учитывается как выделение нового блока и освобождение старого
+	SIMPLE_VECTOR_CONSTEXPR static void CountAllocation([[maybe_unused]] size_t size) noexcept {
+#ifdef SIMPLE_VECTOR_STATS
+		if (!IsConstantEvaluated()) {
+			VectorStats& stats = ThreadVectorStats();
+			++stats.allocations;
+			stats.bytes_allocated += size * sizeof(Type);
+		}
+#endif
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR static void CountDeallocation() noexcept {
+#ifdef SIMPLE_VECTOR_STATS
+		if (!IsConstantEvaluated()) {
+			++ThreadVectorStats().deallocations;
+		}
+#endif
+	}
+};
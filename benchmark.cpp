@@ -0,0 +1,443 @@
+// Сравнение производительности SimpleVector и std::vector.
+// Сборка под Linux:  g++ -std=c++17 -O2 -DNDEBUG benchmark.cpp -o benchmark
+// Запуск:            ./benchmark [--max-size N] [--repetitions R] [--type int|string|pod64|move_only|request] > result.json
+// Результат — JSON со временем одной операции для каждой пары (контейнер, тип, операция, размер).
+// Сценарий request сравнивает SimpleVector, CachedSimpleVector и ArenaSimpleVector на потоке коротких запросов и дополнительно
+// сообщает число обращений к глобальному operator new (поле allocations)
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+	// Число вызовов глобального operator new с начала работы. Бенчмарк однопоточный, атомарность не нужна
+	std::uint64_t g_allocations = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+	++g_allocations;
+	if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+// GCC, встроив замену delete в код std::allocator, видит free для указателя от operator new
+// и ложно считает пару несовпадающей: память здесь выделена malloc в замене operator new выше
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+	using Clock = std::chrono::steady_clock;
+
+	// Не даёт компилятору выбросить вычисление value
+	template <typename T>
+	void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&value) : "memory");
+#else
+		static const volatile void* sink;
+		sink = &value;
+#endif
+	}
+
+	struct Pod64 {
+		std::uint64_t fields[8];
+	};
+
+	bool operator==(const Pod64& lhs, const Pod64& rhs) {
+		return std::memcmp(lhs.fields, rhs.fields, sizeof(lhs.fields)) == 0;
+	}
+
+	bool operator<(const Pod64& lhs, const Pod64& rhs) {
+		return std::lexicographical_compare(std::begin(lhs.fields), std::end(lhs.fields), std::begin(rhs.fields), std::end(rhs.fields));
+	}
+
+	struct MoveOnly {
+		std::unique_ptr<int> value;
+
+		MoveOnly() = default;
+		explicit MoveOnly(int v)
+			: value(std::make_unique<int>(v)) {
+		}
+		MoveOnly(MoveOnly&&) noexcept = default;
+		MoveOnly& operator=(MoveOnly&&) noexcept = default;
+	};
+
+	bool operator==(const MoveOnly& lhs, const MoveOnly& rhs) {
+		return (lhs.value ? *lhs.value : 0) == (rhs.value ? *rhs.value : 0);
+	}
+
+	bool operator<(const MoveOnly& lhs, const MoveOnly& rhs) {
+		return (lhs.value ? *lhs.value : 0) < (rhs.value ? *rhs.value : 0);
+	}
+
+	template <typename T>
+	T MakeValue(size_t i);
+
+	template <>
+	int MakeValue<int>(size_t i) {
+		return static_cast<int>(i);
+	}
+
+	template <>
+	std::string MakeValue<std::string>(size_t i) {
+		return "benchmark value #" + std::to_string(i);
+	}
+
+	template <>
+	Pod64 MakeValue<Pod64>(size_t i) {
+		Pod64 pod{};
+		pod.fields[0] = i;
+		return pod;
+	}
+
+	template <>
+	MoveOnly MakeValue<MoveOnly>(size_t i) {
+		return MoveOnly(static_cast<int>(i));
+	}
+
+	// Единый интерфейс к обоим контейнерам
+	template <typename T>
+	struct StdOps {
+		using Vector = std::vector<T>;
+		static constexpr const char* kName = "std::vector";
+
+		static void PushBack(Vector& v, T&& value) {
+			v.push_back(std::move(value));
+		}
+		static void Reserve(Vector& v, size_t n) {
+			v.reserve(n);
+		}
+		static void Insert(Vector& v, size_t index, T&& value) {
+			v.insert(v.begin() + index, std::move(value));
+		}
+		static void Erase(Vector& v, size_t index) {
+			v.erase(v.begin() + index);
+		}
+		static void Resize(Vector& v, size_t n) {
+			v.resize(n);
+		}
+		static size_t Size(const Vector& v) {
+			return v.size();
+		}
+	};
+
+	template <typename T>
+	struct SimpleOps {
+		using Vector = SimpleVector<T>;
+		static constexpr const char* kName = "SimpleVector";
+
+		static void PushBack(Vector& v, T&& value) {
+			v.PushBack(std::move(value));
+		}
+		static void Reserve(Vector& v, size_t n) {
+			v.Reserve(n);
+		}
+		static void Insert(Vector& v, size_t index, T&& value) {
+			v.Insert(v.begin() + index, std::move(value));
+		}
+		static void Erase(Vector& v, size_t index) {
+			v.Erase(v.begin() + index);
+		}
+		static void Resize(Vector& v, size_t n) {
+			v.Resize(n);
+		}
+		static size_t Size(const Vector& v) {
+			return v.GetSize();
+		}
+	};
+
+	struct Options {
+		size_t max_size = 1000000;
+		int repetitions = 3;
+		std::string type_filter;
+	};
+
+	class JsonReport {
+	public:
+		explicit JsonReport(std::ostream& out)
+			: out_(out) {
+			out_ << "{\n  \"benchmarks\": [";
+		}
+
+		~JsonReport() {
+			out_ << "\n  ]\n}\n";
+		}
+
+		static constexpr std::uint64_t kNoAllocations = static_cast<std::uint64_t>(-1);
+
+		// allocations — число вызовов operator new за один прогон; если не измерялось, поле не выводится
+		void Add(const char* container, const char* type, const char* operation, size_t size, size_t ops, double best_ns,
+			std::uint64_t allocations = kNoAllocations) {
+			out_ << (first_ ? "\n" : ",\n");
+			first_ = false;
+			out_ << "    {\"container\": \"" << container << "\", \"type\": \"" << type << "\", \"operation\": \"" << operation
+				<< "\", \"size\": " << size << ", \"ops\": " << ops << ", \"total_ns\": " << static_cast<std::uint64_t>(best_ns)
+				<< ", \"ns_per_op\": " << best_ns / static_cast<double>(ops);
+			if (allocations != kNoAllocations) {
+				out_ << ", \"allocations\": " << allocations;
+			}
+			out_ << "}";
+			out_.flush();
+		}
+
+	private:
+		std::ostream& out_;
+		bool first_ = true;
+	};
+
+	// Сколько вставок/удалений в начало и середину делается на векторе размера size: каждая стоит O(size)
+	constexpr size_t kShiftOps = 100;
+
+	// Измеряет body(setup()) repetitions раз и возвращает лучшее время. Подготовка в замер не входит
+	template <typename Setup, typename Body>
+	double Measure(int repetitions, Setup setup, Body body) {
+		double best = 0;
+		for (int r = 0; r < repetitions; ++r) {
+			auto state = setup();
+			const auto start = Clock::now();
+			body(state);
+			const auto finish = Clock::now();
+			DoNotOptimize(state);
+			const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+			best = r == 0 ? ns : std::min(best, ns);
+		}
+		return best;
+	}
+
+	template <typename T, typename Ops>
+	void RunContainer(JsonReport& report, const char* type_name, size_t size, const Options& options) {
+		using Vector = typename Ops::Vector;
+		const char* name = Ops::kName;
+		const int reps = options.repetitions;
+		const auto build = [size] {
+			Vector v;
+			for (size_t i = 0; i < size; ++i) {
+				Ops::PushBack(v, MakeValue<T>(i));
+			}
+			return v;
+		};
+		const auto empty = [] {
+			return Vector();
+		};
+
+		report.Add(name, type_name, "PushBack", size, size, Measure(reps, empty, [size](Vector& v) {
+			for (size_t i = 0; i < size; ++i) {
+				Ops::PushBack(v, MakeValue<T>(i));
+			}
+		}));
+		report.Add(name, type_name, "PushBackReserved", size, size, Measure(reps, empty, [size](Vector& v) {
+			Ops::Reserve(v, size);
+			for (size_t i = 0; i < size; ++i) {
+				Ops::PushBack(v, MakeValue<T>(i));
+			}
+		}));
+		report.Add(name, type_name, "InsertFront", size, kShiftOps, Measure(reps, build, [](Vector& v) {
+			for (size_t i = 0; i < kShiftOps; ++i) {
+				Ops::Insert(v, 0, MakeValue<T>(i));
+			}
+		}));
+		report.Add(name, type_name, "InsertMiddle", size, kShiftOps, Measure(reps, build, [](Vector& v) {
+			for (size_t i = 0; i < kShiftOps; ++i) {
+				Ops::Insert(v, Ops::Size(v) / 2, MakeValue<T>(i));
+			}
+		}));
+		const size_t erase_ops = std::min(size, kShiftOps);
+		report.Add(name, type_name, "EraseFront", size, erase_ops, Measure(reps, build, [erase_ops](Vector& v) {
+			for (size_t i = 0; i < erase_ops; ++i) {
+				Ops::Erase(v, 0);
+			}
+		}));
+		report.Add(name, type_name, "EraseMiddle", size, erase_ops, Measure(reps, build, [erase_ops](Vector& v) {
+			for (size_t i = 0; i < erase_ops; ++i) {
+				Ops::Erase(v, Ops::Size(v) / 2);
+			}
+		}));
+		report.Add(name, type_name, "Resize", size, 1, Measure(reps, empty, [size](Vector& v) {
+			Ops::Resize(v, size);
+		}));
+
+		if constexpr (std::is_copy_constructible_v<T>) {
+			const Vector source = build();
+			report.Add(name, type_name, "CopyConstruct", size, 1, Measure(reps, empty, [&source](Vector& v) {
+				Vector copy(source);
+				DoNotOptimize(copy);
+				v.swap(copy);
+			}));
+			report.Add(name, type_name, "CopyAssign", size, 1, Measure(reps, empty, [&source](Vector& v) {
+				v = source;
+			}));
+		}
+
+		const Vector lhs = build();
+		const Vector rhs = build();
+		report.Add(name, type_name, "CompareEqual", size, 1, Measure(reps, empty, [&lhs, &rhs](Vector&) {
+			bool equal = lhs == rhs;
+			DoNotOptimize(equal);
+		}));
+		report.Add(name, type_name, "CompareLess", size, 1, Measure(reps, empty, [&lhs, &rhs](Vector&) {
+			bool less = lhs < rhs;
+			DoNotOptimize(less);
+		}));
+		report.Add(name, type_name, "MoveConstruct", size, 1, Measure(reps, build, [](Vector& v) {
+			Vector moved(std::move(v));
+			DoNotOptimize(moved);
+		}));
+		report.Add(name, type_name, "MoveAssign", size, 1, Measure(reps, build, [](Vector& v) {
+			Vector target;
+			target = std::move(v);
+			DoNotOptimize(target);
+		}));
+	}
+
+	template <typename T>
+	void RunType(JsonReport& report, const char* type_name, const Options& options) {
+		if (!options.type_filter.empty() && options.type_filter != type_name) {
+			return;
+		}
+		for (size_t size = 10; size <= options.max_size; size *= 10) {
+			RunContainer<T, StdOps<T>>(report, type_name, size, options);
+			RunContainer<T, SimpleOps<T>>(report, type_name, size, options);
+		}
+	}
+
+	// Запросов в одном прогоне сценария request: суммарно около миллиона вставок на каждый размер
+	constexpr size_t kRequestElements = 1000000;
+
+	// Один короткий запрос: несколько векторов растут вперемешку, после ответа все они уничтожаются
+	template <typename MakeVector>
+	void ServeRequest(size_t size, MakeVector make) {
+		auto ids = make();
+		auto scores = make();
+		auto offsets = make();
+		for (size_t i = 0; i < size; ++i) {
+			ids.PushBack(static_cast<int>(i));
+			scores.PushBack(static_cast<int>(i * 3));
+			if (i % 4 == 0) {
+				offsets.PushBack(static_cast<int>(i));
+			}
+		}
+		DoNotOptimize(ids);
+		DoNotOptimize(scores);
+		DoNotOptimize(offsets);
+	}
+
+	// Поток запросов на обычных векторах, на векторах с кэшем буферов потока
+	// и на векторах из арены, которая сбрасывается после каждого запроса
+	void RunRequests(JsonReport& report, const Options& options) {
+		if (!options.type_filter.empty() && options.type_filter != "request") {
+			return;
+		}
+		const int reps = options.repetitions;
+		const auto no_state = [] {
+			return 0;
+		};
+		for (size_t size = 10; size <= std::min<size_t>(options.max_size, 100000); size *= 10) {
+			const size_t requests = kRequestElements / size;
+
+			std::uint64_t before = g_allocations;
+			double ns = Measure(reps, no_state, [size, requests](int&) {
+				for (size_t r = 0; r < requests; ++r) {
+					ServeRequest(size, [] {
+						return SimpleVector<int>();
+					});
+				}
+			});
+			report.Add("SimpleVector", "int", "Request", size, requests, ns, (g_allocations - before) / reps);
+
+			BufferCache::Trim();
+			before = g_allocations;
+			ns = Measure(reps, no_state, [size, requests](int&) {
+				for (size_t r = 0; r < requests; ++r) {
+					ServeRequest(size, [] {
+						return CachedSimpleVector<int>();
+					});
+				}
+			});
+			report.Add("CachedSimpleVector", "int", "Request", size, requests, ns, (g_allocations - before) / reps);
+
+			// Арена живёт весь прогон: куски берутся у системы только на первых запросах
+			Arena arena;
+			before = g_allocations;
+			ns = Measure(reps, no_state, [size, requests, &arena](int&) {
+				for (size_t r = 0; r < requests; ++r) {
+					ServeRequest(size, [&arena] {
+						return ArenaSimpleVector<int>(arena);
+					});
+					arena.Reset();
+				}
+			});
+			report.Add("ArenaSimpleVector", "int", "Request", size, requests, ns, (g_allocations - before) / reps);
+		}
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options) {
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			if (i + 1 >= argc) {
+				std::cerr << "Missing value for " << arg << std::endl;
+				return false;
+			}
+			const std::string value = argv[++i];
+			if (arg == "--max-size") {
+				options.max_size = std::stoull(value);
+			}
+			else if (arg == "--repetitions") {
+				options.repetitions = std::max(1, std::stoi(value));
+			}
+			else if (arg == "--type") {
+				options.type_filter = value;
+			}
+			else {
+				std::cerr << "Unknown option " << arg << std::endl;
+				return false;
+			}
+		}
+		return true;
+	}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+	Options options;
+	if (!ParseOptions(argc, argv, options)) {
+		std::cerr << "Usage: benchmark [--max-size N] [--repetitions R] [--type int|string|pod64|move_only|request]" << std::endl;
+		return 1;
+	}
+
+	JsonReport report(std::cout);
+	RunType<int>(report, "int", options);
+	RunType<std::string>(report, "string", options);
+	RunType<Pod64>(report, "pod64", options);
+	RunType<MoveOnly>(report, "move_only", options);
+	RunRequests(report, options);
+	return 0;
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Счётчики кэша буферов одного потока
+struct BufferCacheStats {
+	size_t hits = 0;      // выделение получило буфер из кэша
+	size_t misses = 0;    // выделение обратилось к operator new
+	size_t cached = 0;    // освобождённый буфер остался в кэше
+	size_t released = 0;  // освобождённый буфер возвращён системе: класс переполнен, лимит кэша исчерпан или буфер слишком велик
+};
+
+// Кэш освобождённых буферов текущего потока, разложенных по размерным классам — степеням двойки от 16 байт
+// до kMaxClassBytes. Циклы «создать, вырастить, уничтожить» у SimpleVector раз за разом запрашивают одни и те же
+// размеры (удвоение с 1), и кэш отдаёт их без обращения к глобальному аллокатору.
+// Удержание ограничено: не больше kMaxBuffersPerClass буферов в классе и kMaxCachedBytes байт на поток.
+// Trim() возвращает системе всё сверх заданного объёма. Буфер можно освободить в другом потоке — он попадёт
+// в кэш того потока. Используется через CachingAllocator
+class BufferCache {
+public:
+	static constexpr size_t kMinClassBytes = 16;
+	static constexpr size_t kClassCount = 16;
+	static constexpr size_t kMaxClassBytes = kMinClassBytes << (kClassCount - 1);
+	static constexpr size_t kMaxBuffersPerClass = 8;
+	static constexpr size_t kMaxCachedBytes = size_t(4) << 20;
+
+	// Выделяет не меньше bytes байт, выровненных как max_align_t. Буфер кэшируемого размера всегда занимает
+	// класс целиком, даже если кэш потока уже разрушен: освободить его могут в потоке с живым кэшем,
+	// который затем выдаст его под полный размер класса
+	static void* Allocate(size_t bytes) {
+		BufferCache* cache = ForThisThread();
+		if (bytes > kMaxClassBytes) {
+			if (cache != nullptr) {
+				++cache->stats_.misses;
+			}
+			return ::operator new(bytes);
+		}
+		const size_t index = ClassIndex(bytes);
+		if (cache == nullptr) {
+			return ::operator new(ClassBytes(index));
+		}
+		if (FreeBuffer* buffer = cache->heads_[index]) {
+			cache->heads_[index] = buffer->next;
+			--cache->counts_[index];
+			cache->cached_bytes_ -= ClassBytes(index);
+			++cache->stats_.hits;
+			return buffer;
+		}
+		++cache->stats_.misses;
+		return ::operator new(ClassBytes(index));
+	}
+
+	// Освобождает буфер, выделенный Allocate(bytes) в любом потоке
+	static void Deallocate(void* ptr, size_t bytes) noexcept {
+		BufferCache* cache = ForThisThread();
+		if (cache == nullptr || bytes > kMaxClassBytes) {
+			if (cache != nullptr) {
+				++cache->stats_.released;
+			}
+			::operator delete(ptr);
+			return;
+		}
+		const size_t index = ClassIndex(bytes);
+		const size_t class_bytes = ClassBytes(index);
+		if (cache->counts_[index] == kMaxBuffersPerClass || cache->cached_bytes_ + class_bytes > kMaxCachedBytes) {
+			++cache->stats_.released;
+			::operator delete(ptr);
+			return;
+		}
+		cache->heads_[index] = ::new (ptr) FreeBuffer{ cache->heads_[index] };
+		++cache->counts_[index];
+		cache->cached_bytes_ += class_bytes;
+		++cache->stats_.cached;
+	}
+
+	// Возвращает системе кэшированные буферы текущего потока, начиная с крупных, пока в кэше больше max_bytes байт
+	static void Trim(size_t max_bytes = 0) noexcept {
+		BufferCache* cache = ForThisThread();
+		if (cache != nullptr) {
+			cache->TrimTo(max_bytes);
+		}
+	}
+
+	// Сколько байт сейчас лежит в кэше текущего потока
+	static size_t GetCachedBytes() noexcept {
+		const BufferCache* cache = ForThisThread();
+		return cache != nullptr ? cache->cached_bytes_ : 0;
+	}
+
+	static BufferCacheStats GetStats() noexcept {
+		const BufferCache* cache = ForThisThread();
+		return cache != nullptr ? cache->stats_ : BufferCacheStats();
+	}
+
+	static void ResetStats() noexcept {
+		if (BufferCache* cache = ForThisThread()) {
+			cache->stats_ = BufferCacheStats();
+		}
+	}
+
+	BufferCache(const BufferCache&) = delete;
+	BufferCache& operator=(const BufferCache&) = delete;
+
+private:
+	struct FreeBuffer {
+		FreeBuffer* next;
+	};
+
+	FreeBuffer* heads_[kClassCount] = {};
+	size_t counts_[kClassCount] = {};
+	size_t cached_bytes_ = 0;
+	BufferCacheStats stats_;
+
+	BufferCache() noexcept = default;
+
+	~BufferCache() {
+		TrimTo(0);
+		IsDestroyed() = true;
+	}
+
+	// Флаг тривиально разрушаемый, поэтому читается и после разрушения кэша — из деструкторов других
+	// thread_local объектов, освобождающих векторы при завершении потока
+	static bool& IsDestroyed() noexcept {
+		thread_local bool destroyed = false;
+		return destroyed;
+	}
+
+	// nullptr, если кэш потока уже разрушен: тогда память идёт мимо кэша
+	static BufferCache* ForThisThread() noexcept {
+		if (IsDestroyed()) {
+			return nullptr;
+		}
+		thread_local BufferCache cache;
+		return &cache;
+	}
+
+	static constexpr size_t ClassIndex(size_t bytes) noexcept {
+		size_t index = 0;
+		while (ClassBytes(index) < bytes) {
+			++index;
+		}
+		return index;
+	}
+
+	static constexpr size_t ClassBytes(size_t index) noexcept {
+		return kMinClassBytes << index;
+	}
+
+	void TrimTo(size_t max_bytes) noexcept {
+		for (size_t index = kClassCount; index-- > 0 && cached_bytes_ > max_bytes;) {
+			while (heads_[index] != nullptr && cached_bytes_ > max_bytes) {
+				FreeBuffer* buffer = heads_[index];
+				heads_[index] = buffer->next;
+				--counts_[index];
+				cached_bytes_ -= ClassBytes(index);
+				::operator delete(static_cast<void*>(buffer));
+			}
+		}
+	}
+};
+
+// Аллокатор, берущий буферы из BufferCache текущего потока. Состояния нет, все экземпляры взаимозаменяемы,
+// поэтому вектор можно создать в одном потоке, а уничтожить в другом
+template <typename Type>
+class CachingAllocator {
+	static_assert(alignof(Type) <= alignof(std::max_align_t), "CachingAllocator does not support over-aligned types");
+
+public:
+	using value_type = Type;
+
+	CachingAllocator() noexcept = default;
+
+	template <typename Other>
+	CachingAllocator(const CachingAllocator<Other>&) noexcept {
+	}
+
+	Type* allocate(size_t size) {
+		return static_cast<Type*>(BufferCache::Allocate(ByteSize(size)));
+	}
+
+	void deallocate(Type* raw_ptr, size_t size) noexcept {
+		BufferCache::Deallocate(static_cast<void*>(raw_ptr), size * sizeof(Type));
+	}
+
+private:
+	static size_t ByteSize(size_t size) {
+		if (size > static_cast<size_t>(-1) / sizeof(Type)) {
+			throw std::bad_array_new_length();
+		}
+		return size * sizeof(Type);
+	}
+};
+
+template <typename Type, typename Other>
+inline bool operator==(const CachingAllocator<Type>&, const CachingAllocator<Other>&) noexcept {
+	return true;
+}
+
+template <typename Type, typename Other>
+inline bool operator!=(const CachingAllocator<Type>&, const CachingAllocator<Other>&) noexcept {
+	return false;
+}
@@ -0,0 +1,257 @@
+#pragma once
+
+#include "segment_layout.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор только для добавления, в который могут одновременно писать многие потоки без блокировок.
+// Элементы хранятся в сегментах геометрически растущего размера (см. SegmentLayout) и никогда не переезжают.
+// Производитель занимает слот атомарным fetch_add, конструирует в нём элемент и отмечает слот готовым.
+// Читателям виден опубликованный префикс: GetSize() — число элементов, все из которых уже сконструированы,
+// и элементы [0, GetSize()) можно читать одновременно с добавлением новых.
+// Элемент конструируется до занятия слота, а переносится в слот перемещением, которое не должно бросать исключений.
+// Если после занятия слота не удаётся выделить память под новый сегмент, вызывается std::terminate:
+// незаполненный слот навсегда остановил бы публикацию всех следующих
+template <typename Type, size_t FirstSegmentLog = 6>
+class ConcurrentSimpleVector {
+	static_assert(std::is_nothrow_move_constructible_v<Type>, "Elements are moved into reserved slots, which must not fail");
+
+	using Layout = SegmentLayout<FirstSegmentLog>;
+
+public:
+	class ConstIterator;
+
+	ConcurrentSimpleVector() noexcept = default;
+
+	ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+	ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+	// Разрушает элементы. Одновременных добавлений в этот момент быть не должно
+	~ConcurrentSimpleVector() {
+		const size_t size = reserved_.load(std::memory_order_acquire);
+		for (size_t segment = 0; segment < Layout::kMaxSegments; ++segment) {
+			Segment* storage = segments_[segment].load(std::memory_order_acquire);
+			if (storage == nullptr) {
+				continue;
+			}
+			const size_t start = Layout::SegmentStart(segment);
+			const size_t segment_size = Layout::SegmentSize(segment);
+			for (size_t offset = 0; start + offset < size && offset < segment_size; ++offset) {
+				if (storage->ready[offset].load(std::memory_order_acquire)) {
+					std::destroy_at(storage->data + offset);
+				}
+			}
+			delete storage;
+		}
+	}
+
+	// Возвращает размер опубликованного префикса: все элементы с меньшими индексами сконструированы
+	size_t GetSize() const noexcept {
+		return published_.load(std::memory_order_acquire);
+	}
+
+	bool IsEmpty() const noexcept {
+		return GetSize() == 0;
+	}
+
+	// Возвращает ссылку на элемент с индексом index. index должен быть меньше ранее полученного GetSize()
+	Type& operator[](size_t index) noexcept {
+		assert(index < GetSize());
+		return *Locate(index);
+	}
+
+	const Type& operator[](size_t index) const noexcept {
+		assert(index < GetSize());
+		return *Locate(index);
+	}
+
+	// Возвращает ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если элемент ещё не опубликован
+	Type& At(size_t index) {
+		if (index >= GetSize()) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return *Locate(index);
+	}
+
+	const Type& At(size_t index) const {
+		if (index >= GetSize()) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return *Locate(index);
+	}
+
+	// Итерация по префиксу, опубликованному к моменту вызова begin()/end()
+	ConstIterator begin() const noexcept {
+		return ConstIterator(this, 0);
+	}
+
+	ConstIterator end() const noexcept {
+		return ConstIterator(this, GetSize());
+	}
+
+	void PushBack(const Type& item) {
+		EmplaceBack(item);
+	}
+
+	void PushBack(Type&& item) {
+		EmplaceBack(std::move(item));
+	}
+
+	// Конструирует элемент из args и добавляет его в конец. Можно вызывать из многих потоков одновременно.
+	// Возвращает ссылку на добавленный элемент, которая остаётся действительной до разрушения вектора
+	template <typename... Args>
+	Type& EmplaceBack(Args&&... args) {
+		Type value(std::forward<Args>(args)...);
+		return Publish(std::move(value));
+	}
+
+	// Заранее выделяет сегменты под capacity элементов, чтобы добавление не выделяло память
+	void Reserve(size_t capacity) {
+		if (capacity == 0) {
+			return;
+		}
+		const size_t last = Layout::SegmentOf(capacity - 1);
+		for (size_t segment = 0; segment <= last; ++segment) {
+			EnsureSegment(segment);
+		}
+	}
+
+	// Вместимость уже выделенных сегментов, начиная с первого
+	size_t GetCapacity() const noexcept {
+		size_t segment = 0;
+		while (segment < Layout::kMaxSegments && segments_[segment].load(std::memory_order_acquire) != nullptr) {
+			++segment;
+		}
+		return Layout::SegmentStart(segment);
+	}
+
+	class ConstIterator {
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Type*;
+		using reference = const Type&;
+
+		ConstIterator() noexcept = default;
+
+		reference operator*() const noexcept {
+			return *vector_->Locate(index_);
+		}
+
+		pointer operator->() const noexcept {
+			return vector_->Locate(index_);
+		}
+
+		ConstIterator& operator++() noexcept {
+			++index_;
+			return *this;
+		}
+
+		ConstIterator operator++(int) noexcept {
+			ConstIterator copy = *this;
+			++index_;
+			return copy;
+		}
+
+		bool operator==(const ConstIterator& other) const noexcept {
+			return index_ == other.index_;
+		}
+
+		bool operator!=(const ConstIterator& other) const noexcept {
+			return index_ != other.index_;
+		}
+
+	private:
+		friend class ConcurrentSimpleVector;
+
+		ConstIterator(const ConcurrentSimpleVector* vector, size_t index) noexcept
+			: vector_(vector)
+			, index_(index) {
+		}
+
+		const ConcurrentSimpleVector* vector_ = nullptr;
+		size_t index_ = 0;
+	};
+
+private:
+	// Сырая память сегмента и флаги готовности его слотов
+	struct Segment {
+		explicit Segment(size_t size)
+			: ready(new std::atomic<bool>[size]())
+			, data(std::allocator<Type>().allocate(size))
+			, size(size) {
+		}
+
+		~Segment() {
+			std::allocator<Type>().deallocate(data, size);
+		}
+
+		std::unique_ptr<std::atomic<bool>[]> ready;
+		Type* data;
+		size_t size;
+	};
+
+	std::atomic<Segment*> segments_[Layout::kMaxSegments] = {};
+	// Сколько слотов занято производителями
+	std::atomic<size_t> reserved_{ 0 };
+	// Длина префикса из готовых слотов
+	std::atomic<size_t> published_{ 0 };
+
+	Type* Locate(size_t index) const noexcept {
+		const size_t segment = Layout::SegmentOf(index);
+		return segments_[segment].load(std::memory_order_acquire)->data + Layout::OffsetInSegment(index, segment);
+	}
+
+	// Возвращает сегмент, при необходимости выделяя его. Из выделивших одновременно побеждает один
+	Segment* EnsureSegment(size_t segment) {
+		Segment* storage = segments_[segment].load(std::memory_order_acquire);
+		if (storage != nullptr) {
+			return storage;
+		}
+		auto fresh = std::make_unique<Segment>(Layout::SegmentSize(segment));
+		if (segments_[segment].compare_exchange_strong(storage, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+			return fresh.release();
+		}
+		return storage;
+	}
+
+	Type& Publish(Type&& value) noexcept {
+		const size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+		const size_t segment = Layout::SegmentOf(index);
+		const size_t offset = Layout::OffsetInSegment(index, segment);
+		Segment* storage = EnsureSegment(segment);
+		Type* slot = storage->data + offset;
+		new (slot) Type(std::move(value));
+		// seq_cst: поток, отметивший свой слот, обязан увидеть отметки соседей, иначе оба могли бы
+		// не продвинуть публикацию друг через друга
+		storage->ready[offset].store(true, std::memory_order_seq_cst);
+		AdvancePublished();
+		return *slot;
+	}
+
+	bool IsReady(size_t index) const noexcept {
+		const size_t segment = Layout::SegmentOf(index);
+		const Segment* storage = segments_[segment].load(std::memory_order_acquire);
+		return storage != nullptr && storage->ready[Layout::OffsetInSegment(index, segment)].load(std::memory_order_seq_cst);
+	}
+
+	// Продвигает опубликованный префикс через все готовые слоты. Каждый производитель вызывает его после
+	// отметки своего слота, поэтому последний дописавший поток публикует и слоты обогнавших его
+	void AdvancePublished() noexcept {
+		size_t published = published_.load(std::memory_order_seq_cst);
+		while (IsReady(published)) {
+			if (published_.compare_exchange_weak(published, published + 1, std::memory_order_seq_cst)) {
+				++published;
+			}
+		}
+	}
+};
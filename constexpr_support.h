@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+
+// С C++20 память можно выделять и освобождать при вычислении на этапе компиляции (constexpr std::allocator),
+// поэтому SimpleVector и ArrayPtr там помечены SIMPLE_VECTOR_CONSTEXPR: в C++20 это constexpr, в C++17 — ничего.
+// SIMPLE_VECTOR_HAS_CONSTEXPR равен 1, если constexpr-контейнеры доступны
+#if defined(__cpp_lib_constexpr_dynamic_alloc) && defined(__cpp_lib_is_constant_evaluated)
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 1
+#define SIMPLE_VECTOR_CONSTEXPR constexpr
+#else
+#define SIMPLE_VECTOR_HAS_CONSTEXPR 0
+#define SIMPLE_VECTOR_CONSTEXPR
+#endif
+
+// Идёт ли вычисление на этапе компиляции. Там недоступны memcpy/memmove, потоки, SIMD и thread_local,
+// и быстрые пути уступают место поэлементным. В C++17 всегда false
+constexpr bool IsConstantEvaluated() noexcept {
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+	return std::is_constant_evaluated();
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define SIMPLE_VECTOR_FILL_X86 1
+#endif
+
+// Заполнение сырой памяти арифметическими значениями для конструкторов и Resize SimpleVector.
+// Нулевое значение заполняется memset, остальные — std::fill_n, который компилятор векторизует.
+// Буферы больше кэша заполняются потоковыми (non-temporal) записями, не вытесняющими кэш,
+// а самые большие делятся между потоками: каждый поток первым касается своих страниц,
+// и ОС размещает их в памяти его NUMA-узла
+namespace fast_fill {
+
+	// С какого объёма запись идёт мимо кэша
+	inline constexpr size_t kNonTemporalBytes = size_t(8) << 20;
+
+	// С какого объёма заполнение делится между потоками и сколько байт минимум достаётся каждому
+	inline constexpr size_t kParallelBytes = size_t(64) << 20;
+	inline constexpr size_t kBytesPerThread = size_t(16) << 20;
+
+	template <typename Type>
+	inline constexpr bool kSupported = std::is_arithmetic_v<Type>;
+
+	template <typename Type>
+	bool IsZeroBytes(const Type& value) noexcept {
+		unsigned char bytes[sizeof(Type)];
+		std::memcpy(bytes, &value, sizeof(Type));
+		return std::all_of(std::begin(bytes), std::end(bytes), [](unsigned char byte) {
+			return byte == 0;
+		});
+	}
+
+#ifdef SIMPLE_VECTOR_FILL_X86
+	// Заполняет count элементов потоковыми записями по 16 байт. Размер Type — 2, 4 или 8 байт
+	template <typename Type>
+	void FillNonTemporal(Type* dest, size_t count, const Type& value) noexcept {
+		std::uint64_t pattern = 0;
+		for (size_t offset = 0; offset < sizeof(pattern); offset += sizeof(Type)) {
+			std::memcpy(reinterpret_cast<unsigned char*>(&pattern) + offset, &value, sizeof(Type));
+		}
+		// Потоковые записи требуют выравнивания на 16 байт: голову заполняем обычными записями
+		size_t head = 0;
+		while (head < count && reinterpret_cast<std::uintptr_t>(dest + head) % 16 != 0) {
+			dest[head++] = value;
+		}
+		const __m128i block = _mm_set1_epi64x(static_cast<long long>(pattern));
+		constexpr size_t kPerBlock = 16 / sizeof(Type);
+		size_t i = head;
+		for (; i + kPerBlock <= count; i += kPerBlock) {
+			_mm_stream_si128(reinterpret_cast<__m128i*>(dest + i), block);
+		}
+		_mm_sfence();
+		std::fill(dest + i, dest + count, value);
+	}
+#endif
+
+	// Заполняет [dest, dest + count) значением value в текущем потоке
+	template <typename Type>
+	void FillSerial(Type* dest, size_t count, const Type& value, size_t non_temporal_bytes = kNonTemporalBytes) noexcept {
+		static_assert(kSupported<Type>);
+		if (count == 0) {
+			return;
+		}
+		if (sizeof(Type) == 1 || IsZeroBytes(value)) {
+			unsigned char byte;
+			std::memcpy(&byte, &value, 1);
+			std::memset(dest, byte, count * sizeof(Type));
+			return;
+		}
+#ifdef SIMPLE_VECTOR_FILL_X86
+		if constexpr (sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8) {
+			if (count * sizeof(Type) >= non_temporal_bytes) {
+				FillNonTemporal(dest, count, value);
+				return;
+			}
+		}
+#endif
+		std::fill_n(dest, count, value);
+	}
+
+	// Заполняет [dest, dest + count) значением value, при большом объёме — несколькими потоками.
+	// Если поток создать не удалось, его часть заполняется в вызывающем потоке
+	template <typename Type>
+	void Fill(Type* dest, size_t count, const Type& value, size_t parallel_bytes = kParallelBytes,
+		size_t non_temporal_bytes = kNonTemporalBytes) noexcept {
+		const size_t bytes = count * sizeof(Type);
+		if (bytes < parallel_bytes) {
+			FillSerial(dest, count, value, non_temporal_bytes);
+			return;
+		}
+		// hardware_concurrency — системный вызов, поэтому число ядер запрашивается один раз
+		static const size_t hardware = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		const size_t threads = std::min(hardware, std::max<size_t>(bytes / kBytesPerThread, 1));
+		if (threads <= 1) {
+			FillSerial(dest, count, value, non_temporal_bytes);
+			return;
+		}
+
+		const size_t per_thread = (count + threads - 1) / threads;
+		std::vector<std::thread> workers;
+		size_t begin = 0;
+		try {
+			workers.reserve(threads - 1);
+			// Последнюю часть заполняет вызывающий поток
+			for (; begin + per_thread < count; begin += per_thread) {
+				workers.emplace_back([=, &value] {
+					FillSerial(dest + begin, per_thread, value, non_temporal_bytes);
+				});
+			}
+		}
+		catch (...) {
+		}
+		FillSerial(dest + begin, count - begin, value, non_temporal_bytes);
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+}  // namespace fast_fill
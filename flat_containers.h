@@ -0,0 +1,348 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+// Отсортированные ассоциативные контейнеры поверх SimpleVector: FlatSet и FlatMap.
+// Элементы лежат одним непрерывным массивом в порядке Compare, без узлов и указателей, поэтому таблица
+// занимает меньше памяти, чем std::set/std::map, а поиск идёт двоичным поиском по кэш-дружественному массиву.
+// Одиночная вставка и удаление сдвигают хвост за O(n) — контейнеры рассчитаны на таблицы, которые в основном читают.
+// Много элементов сразу вставляет InsertRange: он дописывает их в конец, сортирует и сливает с имеющимися
+// за один проход вместо k вставок со сдвигом. Любая вставка делает недействительными итераторы и ссылки
+
+namespace flat_detail {
+
+	// Первый элемент [first, first + count), для которого before(element) == false. Диапазон должен быть
+	// разбит предикатом: сначала все true, затем все false. Сужение идёт без ветвлений по результату сравнения
+	// (условное присваивание вместо перехода), поэтому ошибки предсказания переходов не тормозят поиск
+	template <typename It, typename Predicate>
+	It PartitionPoint(It first, size_t count, Predicate before) {
+		if (count == 0) {
+			return first;
+		}
+		while (count > 1) {
+			const size_t half = count / 2;
+			first = before(first[half]) ? first + half : first;
+			count -= half;
+		}
+		return before(*first) ? first + 1 : first;
+	}
+
+	// Общая часть FlatSet и FlatMap: отсортированный без повторов SimpleVector значений Value,
+	// ключ которых извлекает KeyOf
+	template <typename Key, typename Value, typename KeyOf, typename Compare, typename Alloc>
+	class FlatBase {
+	public:
+		using Storage = SimpleVector<Value, Alloc>;
+		using Iterator = typename Storage::Iterator;
+		using ConstIterator = typename Storage::ConstIterator;
+
+		FlatBase() = default;
+
+		explicit FlatBase(const Compare& compare, const Alloc& alloc = Alloc())
+			: storage_(alloc)
+			, compare_(compare) {
+		}
+
+		size_t GetSize() const noexcept {
+			return storage_.GetSize();
+		}
+
+		size_t GetCapacity() const noexcept {
+			return storage_.GetCapacity();
+		}
+
+		bool IsEmpty() const noexcept {
+			return storage_.IsEmpty();
+		}
+
+		void Clear() noexcept {
+			storage_.Clear();
+		}
+
+		void Reserve(size_t new_capacity) {
+			storage_.Reserve(new_capacity);
+		}
+
+		void ShrinkToFit() {
+			storage_.ShrinkToFit();
+		}
+
+		// Отсортированные элементы одним массивом
+		const Storage& GetStorage() const noexcept {
+			return storage_;
+		}
+
+		ConstIterator begin() const noexcept {
+			return storage_.begin();
+		}
+
+		ConstIterator end() const noexcept {
+			return storage_.end();
+		}
+
+		ConstIterator cbegin() const noexcept {
+			return storage_.cbegin();
+		}
+
+		ConstIterator cend() const noexcept {
+			return storage_.cend();
+		}
+
+		// Первый элемент с ключом не меньше key
+		ConstIterator LowerBound(const Key& key) const {
+			return PartitionPoint(storage_.begin(), storage_.GetSize(), [&](const Value& value) {
+				return compare_(KeyOf()(value), key);
+			});
+		}
+
+		// Первый элемент с ключом больше key
+		ConstIterator UpperBound(const Key& key) const {
+			return PartitionPoint(storage_.begin(), storage_.GetSize(), [&](const Value& value) {
+				return !compare_(key, KeyOf()(value));
+			});
+		}
+
+		// Возвращает итератор на элемент с ключом key или end()
+		ConstIterator Find(const Key& key) const {
+			const ConstIterator it = LowerBound(key);
+			return it != end() && !compare_(key, KeyOf()(*it)) ? it : end();
+		}
+
+		bool Contains(const Key& key) const {
+			return Find(key) != end();
+		}
+
+		size_t Count(const Key& key) const {
+			return Contains(key) ? 1 : 0;
+		}
+
+		// Удаляет элемент с ключом key. Возвращает число удалённых элементов
+		size_t Erase(const Key& key) {
+			const ConstIterator it = Find(key);
+			if (it == end()) {
+				return 0;
+			}
+			storage_.Erase(it);
+			return 1;
+		}
+
+		Iterator Erase(ConstIterator pos) {
+			return storage_.Erase(pos);
+		}
+
+		Iterator Erase(ConstIterator first, ConstIterator last) {
+			return storage_.Erase(first, last);
+		}
+
+		// Вставляет элементы [first, last), ключей которых ещё нет. Из повторяющихся в диапазоне ключей
+		// вставляется первый. Новые элементы дописываются в конец, сортируются и сливаются с имеющимися
+		// одним проходом: O(n + k log k) вместо O(n * k) у k одиночных вставок. Если сравнение или перемещение
+		// бросит исключение во время слияния, контейнер очищается
+		template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+		void InsertRange(InputIt first, InputIt last) {
+			const size_t old_size = storage_.GetSize();
+			storage_.Append(first, last);
+			const auto less = [this](const Value& lhs, const Value& rhs) {
+				return compare_(KeyOf()(lhs), KeyOf()(rhs));
+			};
+			const auto equivalent = [this](const Value& lhs, const Value& rhs) {
+				return !compare_(KeyOf()(lhs), KeyOf()(rhs));
+			};
+			const Iterator middle = storage_.begin() + old_size;
+			// Устойчивые сортировка и слияние ставят имеющийся элемент перед новым с тем же ключом,
+			// а новые — в порядке диапазона, и unique оставляет первый из равных
+			Iterator new_end;
+			try {
+				std::stable_sort(middle, storage_.end(), less);
+				new_end = std::unique(middle, storage_.end(), equivalent);
+			}
+			catch (...) {
+				storage_.Erase(middle, storage_.end());
+				throw;
+			}
+			try {
+				std::inplace_merge(storage_.begin(), middle, new_end, less);
+			}
+			catch (...) {
+				// Частично слитый массив не отсортирован, а восстановить прежний нельзя
+				storage_.Clear();
+				throw;
+			}
+			storage_.Erase(std::unique(storage_.begin(), new_end, equivalent), storage_.end());
+		}
+
+		void InsertRange(std::initializer_list<Value> init) {
+			InsertRange(init.begin(), init.end());
+		}
+
+		void swap(FlatBase& other) noexcept {
+			storage_.swap(other.storage_);
+			std::swap(compare_, other.compare_);
+		}
+
+	protected:
+		Storage storage_;
+		Compare compare_;
+
+		Iterator MutableLowerBound(const Key& key) {
+			return storage_.begin() + (LowerBound(key) - cbegin());
+		}
+
+		bool IsKeyAt(ConstIterator it, const Key& key) const {
+			return it != end() && !compare_(key, KeyOf()(*it));
+		}
+
+		// Вставляет значение, если ключа ещё нет. Возвращает итератор на элемент с этим ключом и признак вставки
+		template <typename... Args>
+		std::pair<Iterator, bool> EmplaceUnique(const Key& key, Args&&... args) {
+			const Iterator it = MutableLowerBound(key);
+			if (IsKeyAt(it, key)) {
+				return { it, false };
+			}
+			return { storage_.Emplace(it, std::forward<Args>(args)...), true };
+		}
+	};
+
+	struct Identity {
+		template <typename Type>
+		const Type& operator()(const Type& value) const noexcept {
+			return value;
+		}
+	};
+
+	struct First {
+		template <typename Pair>
+		const typename Pair::first_type& operator()(const Pair& value) const noexcept {
+			return value.first;
+		}
+	};
+
+}  // namespace flat_detail
+
+// Отсортированное множество уникальных ключей
+template <typename Key, typename Compare = std::less<Key>, typename Alloc = std::allocator<Key>>
+class FlatSet : public flat_detail::FlatBase<Key, Key, flat_detail::Identity, Compare, Alloc> {
+	using Base = flat_detail::FlatBase<Key, Key, flat_detail::Identity, Compare, Alloc>;
+
+public:
+	using typename Base::ConstIterator;
+	using Base::Base;
+
+	FlatSet() = default;
+
+	FlatSet(std::initializer_list<Key> init) {
+		Base::InsertRange(init);
+	}
+
+	template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+	FlatSet(InputIt first, InputIt last) {
+		Base::InsertRange(first, last);
+	}
+
+	// Вставляет key, если его ещё нет. Возвращает итератор на ключ и признак вставки
+	std::pair<ConstIterator, bool> Insert(const Key& key) {
+		return Base::EmplaceUnique(key, key);
+	}
+
+	std::pair<ConstIterator, bool> Insert(Key&& key) {
+		return Base::EmplaceUnique(key, std::move(key));
+	}
+
+	void swap(FlatSet& other) noexcept {
+		Base::swap(other);
+	}
+};
+
+// Отсортированный словарь с уникальными ключами. Пары хранятся как std::pair<Key, Value>, а не с константным
+// ключом, чтобы их можно было сдвигать и сортировать; менять ключ через итератор нельзя
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Alloc = std::allocator<std::pair<Key, Value>>>
+class FlatMap : public flat_detail::FlatBase<Key, std::pair<Key, Value>, flat_detail::First, Compare, Alloc> {
+	using Base = flat_detail::FlatBase<Key, std::pair<Key, Value>, flat_detail::First, Compare, Alloc>;
+
+public:
+	using typename Base::Iterator;
+	using typename Base::ConstIterator;
+	using Base::Base;
+	using Base::begin;
+	using Base::end;
+	using Base::Find;
+
+	FlatMap() = default;
+
+	FlatMap(std::initializer_list<std::pair<Key, Value>> init) {
+		Base::InsertRange(init);
+	}
+
+	template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+	FlatMap(InputIt first, InputIt last) {
+		Base::InsertRange(first, last);
+	}
+
+	Iterator begin() noexcept {
+		return Base::storage_.begin();
+	}
+
+	Iterator end() noexcept {
+		return Base::storage_.end();
+	}
+
+	Iterator Find(const Key& key) {
+		const Iterator it = Base::MutableLowerBound(key);
+		return Base::IsKeyAt(it, key) ? it : end();
+	}
+
+	// Возвращает значение по ключу. Выбрасывает исключение std::out_of_range, если ключа нет
+	Value& At(const Key& key) {
+		const Iterator it = Find(key);
+		if (it == end()) {
+			throw std::out_of_range("Error: key not found");
+		}
+		return it->second;
+	}
+
+	const Value& At(const Key& key) const {
+		const ConstIterator it = Find(key);
+		if (it == end()) {
+			throw std::out_of_range("Error: key not found");
+		}
+		return it->second;
+	}
+
+	// Возвращает значение по ключу, вставляя значение по умолчанию, если ключа нет
+	Value& operator[](const Key& key) {
+		return Base::EmplaceUnique(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+	}
+
+	// Вставляет пару, если ключа ещё нет. Возвращает итератор на пару с этим ключом и признак вставки
+	std::pair<Iterator, bool> Insert(const std::pair<Key, Value>& item) {
+		return Base::EmplaceUnique(item.first, item);
+	}
+
+	std::pair<Iterator, bool> Insert(std::pair<Key, Value>&& item) {
+		return Base::EmplaceUnique(item.first, std::move(item));
+	}
+
+	// Вставляет пару или присваивает значение, если ключ уже есть
+	template <typename M>
+	std::pair<Iterator, bool> InsertOrAssign(const Key& key, M&& value) {
+		const auto result = Base::EmplaceUnique(key, key, std::forward<M>(value));
+		if (!result.second) {
+			result.first->second = std::forward<M>(value);
+		}
+		return result;
+	}
+
+	void swap(FlatMap& other) noexcept {
+		Base::swap(other);
+	}
+};
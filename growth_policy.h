@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Политики роста вместимости SimpleVector.
+// Grow(capacity, element_size) возвращает новую вместимость заполненного вектора (строго больше capacity).
+// Shrink(capacity, size) возвращает вместимость, до которой вектор ужимается после PopBack/Clear,
+// и вызывается, только если kAutoShrink == true
+
+// Удвоение: 0 -> 1 -> 2 -> 4 -> ...
+struct DoublingGrowth {
+	static constexpr bool kAutoShrink = false;
+
+	static constexpr size_t Grow(size_t capacity, size_t) noexcept {
+		return capacity == 0 ? 1 : capacity * 2;
+	}
+
+	static constexpr size_t Shrink(size_t capacity, size_t) noexcept {
+		return capacity;
+	}
+};
+
+// Рост в полтора раза: освобождённые блоки со временем могут быть переиспользованы под следующий рост
+struct OneAndHalfGrowth {
+	static constexpr bool kAutoShrink = false;
+
+	static constexpr size_t Grow(size_t capacity, size_t) noexcept {
+		return std::max(capacity + capacity / 2, capacity + 1);
+	}
+
+	static constexpr size_t Shrink(size_t capacity, size_t) noexcept {
+		return capacity;
+	}
+};
+
+// Рост в полтора раза с округлением размера блока вверх до размерного класса аллокатора
+// (четыре класса на каждую степень двойки, как в jemalloc/tcmalloc). Хвост класса, который аллокатор
+// всё равно отдал бы, становится полезной вместимостью
+struct SizeClassGrowth {
+	static constexpr bool kAutoShrink = false;
+
+	static constexpr size_t RoundToSizeClass(size_t bytes) noexcept {
+		constexpr size_t kMinClass = 16;
+		if (bytes <= kMinClass) {
+			return kMinClass;
+		}
+		size_t group = kMinClass;
+		while (group * 2 < bytes) {
+			group *= 2;
+		}
+		const size_t step = std::max(group / 4, kMinClass);
+		return (bytes + step - 1) / step * step;
+	}
+
+	static constexpr size_t Grow(size_t capacity, size_t element_size) noexcept {
+		const size_t requested = OneAndHalfGrowth::Grow(capacity, element_size);
+		return RoundToSizeClass(requested * element_size) / element_size;
+	}
+
+	static constexpr size_t Shrink(size_t capacity, size_t) noexcept {
+		return capacity;
+	}
+};
+
+// Удвоение, но блоки от страницы и больше округляются до целого числа страниц
+template <size_t PageSize = 4096>
+struct PageRoundedGrowth {
+	static_assert((PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+	static constexpr bool kAutoShrink = false;
+
+	static constexpr size_t Grow(size_t capacity, size_t element_size) noexcept {
+		const size_t requested = DoublingGrowth::Grow(capacity, element_size);
+		const size_t bytes = requested * element_size;
+		if (bytes < PageSize) {
+			return requested;
+		}
+		return ((bytes + PageSize - 1) & ~(PageSize - 1)) / element_size;
+	}
+
+	static constexpr size_t Shrink(size_t capacity, size_t) noexcept {
+		return capacity;
+	}
+};
+
+// Добавляет к политике Base автоматическое ужатие с гистерезисом: когда после PopBack/Clear элементов
+// остаётся не больше четверти вместимости, вместимость уменьшается вдвое. Зазор между порогами роста
+// и ужатия не даёт вектору перевыделять память на каждом чередовании PushBack/PopBack
+template <typename Base = DoublingGrowth>
+struct HysteresisShrink : Base {
+	static constexpr bool kAutoShrink = true;
+
+	static constexpr size_t Shrink(size_t capacity, size_t size) noexcept {
+		if (size > capacity / 4) {
+			return capacity;
+		}
+		return capacity / 2;
+	}
+};
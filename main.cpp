@@ -1,4 +1,15 @@
 #include "simple_vector.h"
+#include "malloc_allocator.h"
+#include "mmap_allocator.h"
+#include "mapped_simple_vector.h"
+#include "simple_vector_io.h"
+#include "parallel_algorithms.h"
+#include "concurrent_simple_vector.h"
+#include "stable_simple_vector.h"
+#include "shared_simple_vector.h"
+#include "soa_vector.h"
+#include "flat_containers.h"
+#include "small_simple_vector.h"
 
 // Tests
 #include "tests.h"
@@ -19,6 +30,30 @@ int main() {
     TestNoncopiableInsert();
     TestNoncopiableErase();
     TestNoncopiableResize();
+    TestReserveDoesNotConstruct();
+    TestInsertEraseInPlace();
+    TestPmrAllocator();
+    TestSmallVector();
+    TestTriviallyRelocatableGrowth();
+    TestGrowthPolicies();
+    TestEmplace();
+    TestRangeOperations();
+    TestVectorStats();
+    TestMmapAllocator();
+    TestMappedVector();
+    TestBinaryIO();
+    TestSimdComparisons();
+    TestFastFill();
+    TestParallelAlgorithms();
+    TestConcurrentVector();
+    TestStableVector();
+    TestSharedVector();
+    TestAlignedVector();
+    TestSoAVector();
+    TestFlatContainers();
+    TestConstexprVector();
+    TestArenaVector();
+    TestBufferCache();
 
     return 0;
 }
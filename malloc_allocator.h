@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Аллокатор поверх malloc/free. Умеет reallocate, поэтому SimpleVector с тривиально
+// перемещаемыми элементами растёт через realloc, часто без копирования вовсе
+template <typename Type>
+class MallocAllocator {
+	static_assert(alignof(Type) <= alignof(std::max_align_t), "malloc does not honour extended alignment");
+
+public:
+	using value_type = Type;
+
+	MallocAllocator() noexcept = default;
+
+	template <typename Other>
+	MallocAllocator(const MallocAllocator<Other>&) noexcept {
+	}
+
+	Type* allocate(size_t size) {
+		CheckSize(size);
+		void* raw_ptr = std::malloc(size * sizeof(Type));
+		if (raw_ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return static_cast<Type*>(raw_ptr);
+	}
+
+	void deallocate(Type* raw_ptr, size_t) noexcept {
+		std::free(raw_ptr);
+	}
+
+	// Расширяет или сужает блок, сохраняя его содержимое побайтно
+	Type* reallocate(Type* raw_ptr, size_t, size_t new_size) {
+		CheckSize(new_size);
+		void* new_ptr = std::realloc(static_cast<void*>(raw_ptr), new_size * sizeof(Type));
+		if (new_ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+		return static_cast<Type*>(new_ptr);
+	}
+
+private:
+	static void CheckSize(size_t size) {
+		if (size > static_cast<size_t>(-1) / sizeof(Type)) {
+			throw std::bad_array_new_length();
+		}
+	}
+};
+
+template <typename Type, typename Other>
+inline bool operator==(const MallocAllocator<Type>&, const MallocAllocator<Other>&) noexcept {
+	return true;
+}
+
+template <typename Type, typename Other>
+inline bool operator!=(const MallocAllocator<Type>&, const MallocAllocator<Other>&) noexcept {
+	return false;
+}
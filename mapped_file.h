@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Режим отображения файла в память
+enum class MapMode {
+	kReadWrite,    // изменения пишутся в файл, файл можно расширять
+	kReadOnly,     // только чтение
+	kCopyOnWrite,  // изменения видны только этому процессу и в файл не попадают
+};
+
+// Владеет файлом, целиком отображённым в память. Для MappedSimpleVector играет ту же роль, что ArrayPtr
+// для SimpleVector: отвечает только за байты, не зная об элементах.
+// Ошибки ОС сообщаются исключением std::system_error
+class MappedFile {
+public:
+	MappedFile() noexcept = default;
+
+	// Открывает файл path. Если create_size != 0, файл создаётся (или обрезается) размером create_size байт,
+	// иначе отображается существующий файл целиком. Создание возможно только в режиме kReadWrite
+	MappedFile(const std::string& path, MapMode mode, size_t create_size = 0)
+		: mode_(mode) {
+		Open(path, create_size);
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept {
+		swap(other);
+	}
+
+	MappedFile& operator=(MappedFile&& other) noexcept {
+		if (this != &other) {
+			MappedFile temp(std::move(other));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	~MappedFile() {
+		Close();
+	}
+
+	std::byte* Data() const noexcept {
+		return data_;
+	}
+
+	size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	MapMode GetMode() const noexcept {
+		return mode_;
+	}
+
+	// Меняет размер отображения до new_size байт с сохранением содержимого. В режиме kReadWrite вместе с ним
+	// меняется размер файла, а под Linux страницы переотображаются через mremap без копирования.
+	// В режиме kCopyOnWrite файл не трогается: содержимое переезжает в анонимную память процесса
+	void Resize(size_t new_size) {
+		if (new_size == size_) {
+			return;
+		}
+		if (mode_ == MapMode::kReadOnly) {
+			throw std::system_error(std::make_error_code(std::errc::read_only_file_system), "MappedFile::Resize");
+		}
+		if (mode_ == MapMode::kCopyOnWrite || anonymous_) {
+			std::byte* new_data = MapAnonymous(new_size);
+			std::memcpy(new_data, data_, size_ < new_size ? size_ : new_size);
+			Unmap();
+			data_ = new_data;
+			size_ = new_size;
+			anonymous_ = true;
+			return;
+		}
+		ResizeFile(new_size);
+	}
+
+	// Сбрасывает изменённые страницы на диск. Без вызова они записываются ОС в фоне
+	void Flush() {
+		if (data_ == nullptr || mode_ != MapMode::kReadWrite) {
+			return;
+		}
+#ifdef _WIN32
+		if (!FlushViewOfFile(data_, 0) || !FlushFileBuffers(file_)) {
+			ThrowLastError("FlushViewOfFile");
+		}
+#else
+		if (msync(data_, size_, MS_SYNC) != 0) {
+			ThrowLastError("msync");
+		}
+#endif
+	}
+
+	void swap(MappedFile& other) noexcept {
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(mode_, other.mode_);
+		std::swap(anonymous_, other.anonymous_);
+		std::swap(file_, other.file_);
+#ifdef _WIN32
+		std::swap(mapping_, other.mapping_);
+#endif
+	}
+
+private:
+	std::byte* data_ = nullptr;
+	size_t size_ = 0;
+	MapMode mode_ = MapMode::kReadOnly;
+	// Отображение уже не связано с файлом (kCopyOnWrite после Resize)
+	bool anonymous_ = false;
+#ifdef _WIN32
+	HANDLE file_ = INVALID_HANDLE_VALUE;
+	HANDLE mapping_ = nullptr;
+#else
+	int file_ = -1;
+#endif
+
+#ifdef _WIN32
+	[[noreturn]] static void ThrowLastError(const char* what) {
+		throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), what);
+	}
+
+	void Open(const std::string& path, size_t create_size) {
+		const bool writable = mode_ == MapMode::kReadWrite;
+		file_ = CreateFileA(path.c_str(), writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+			create_size != 0 ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) {
+			ThrowLastError("CreateFile");
+		}
+		size_t size = create_size;
+		if (size == 0) {
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file_, &file_size)) {
+				Close();
+				ThrowLastError("GetFileSizeEx");
+			}
+			size = static_cast<size_t>(file_size.QuadPart);
+		}
+		try {
+			MapFile(size);
+		}
+		catch (...) {
+			Close();
+			throw;
+		}
+	}
+
+	// Отображает первые size байт файла, при необходимости расширяя его
+	void MapFile(size_t size) {
+		const DWORD protect = mode_ == MapMode::kReadWrite ? PAGE_READWRITE : mode_ == MapMode::kReadOnly ? PAGE_READONLY : PAGE_WRITECOPY;
+		const DWORD access = mode_ == MapMode::kReadWrite ? FILE_MAP_WRITE : mode_ == MapMode::kReadOnly ? FILE_MAP_READ : FILE_MAP_COPY;
+		const unsigned long long size64 = size;
+		mapping_ = CreateFileMappingA(file_, nullptr, protect, static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), nullptr);
+		if (mapping_ == nullptr) {
+			ThrowLastError("CreateFileMapping");
+		}
+		data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, access, 0, 0, size));
+		if (data_ == nullptr) {
+			CloseHandle(std::exchange(mapping_, nullptr));
+			ThrowLastError("MapViewOfFile");
+		}
+		size_ = size;
+	}
+
+	void ResizeFile(size_t new_size) {
+		const size_t old_size = size_;
+		Unmap();
+		if (new_size < old_size) {
+			LARGE_INTEGER position;
+			position.QuadPart = static_cast<LONGLONG>(new_size);
+			if (!SetFilePointerEx(file_, position, nullptr, FILE_BEGIN) || !SetEndOfFile(file_)) {
+				ThrowLastError("SetEndOfFile");
+			}
+		}
+		MapFile(new_size);
+	}
+
+	static std::byte* MapAnonymous(size_t size) {
+		void* data = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (data == nullptr) {
+			ThrowLastError("VirtualAlloc");
+		}
+		return static_cast<std::byte*>(data);
+	}
+
+	// Снимает отображение. Размер обнуляется вместе с указателем, чтобы не остался устаревшим
+	void Unmap() noexcept {
+		if (data_ != nullptr) {
+			if (anonymous_) {
+				VirtualFree(data_, 0, MEM_RELEASE);
+			}
+			else {
+				UnmapViewOfFile(data_);
+			}
+			data_ = nullptr;
+		}
+		size_ = 0;
+		if (mapping_ != nullptr) {
+			CloseHandle(std::exchange(mapping_, nullptr));
+		}
+	}
+
+	void Close() noexcept {
+		Unmap();
+		if (file_ != INVALID_HANDLE_VALUE) {
+			CloseHandle(std::exchange(file_, INVALID_HANDLE_VALUE));
+		}
+	}
+#else
+	[[noreturn]] static void ThrowLastError(const char* what) {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	void Open(const std::string& path, size_t create_size) {
+		const bool writable = mode_ == MapMode::kReadWrite;
+		const int flags = (writable ? O_RDWR : O_RDONLY) | (create_size != 0 ? O_CREAT | O_TRUNC : 0);
+		file_ = ::open(path.c_str(), flags, 0644);
+		if (file_ < 0) {
+			ThrowLastError("open");
+		}
+		try {
+			size_t size = create_size;
+			if (size == 0) {
+				struct stat info;
+				if (fstat(file_, &info) != 0) {
+					ThrowLastError("fstat");
+				}
+				size = static_cast<size_t>(info.st_size);
+			}
+			else if (ftruncate(file_, static_cast<off_t>(size)) != 0) {
+				ThrowLastError("ftruncate");
+			}
+			MapFile(size);
+		}
+		catch (...) {
+			Close();
+			throw;
+		}
+	}
+
+	void MapFile(size_t size) {
+		if (size == 0) {
+			return;
+		}
+		const int prot = mode_ == MapMode::kReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+		const int flags = mode_ == MapMode::kReadWrite ? MAP_SHARED : MAP_PRIVATE;
+		void* data = mmap(nullptr, size, prot, flags, file_, 0);
+		if (data == MAP_FAILED) {
+			ThrowLastError("mmap");
+		}
+		data_ = static_cast<std::byte*>(data);
+		size_ = size;
+	}
+
+	void ResizeFile(size_t new_size) {
+		if (ftruncate(file_, static_cast<off_t>(new_size)) != 0) {
+			ThrowLastError("ftruncate");
+		}
+#ifdef __linux__
+		if (data_ != nullptr) {
+			void* data = mremap(data_, size_, new_size, MREMAP_MAYMOVE);
+			if (data == MAP_FAILED) {
+				ThrowLastError("mremap");
+			}
+			data_ = static_cast<std::byte*>(data);
+			size_ = new_size;
+			return;
+		}
+#endif
+		Unmap();
+		MapFile(new_size);
+	}
+
+	static std::byte* MapAnonymous(size_t size) {
+		void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED) {
+			ThrowLastError("mmap");
+		}
+		return static_cast<std::byte*>(data);
+	}
+
+	// Снимает отображение. Размер обнуляется вместе с указателем, чтобы не остался устаревшим
+	void Unmap() noexcept {
+		if (data_ != nullptr) {
+			munmap(data_, size_);
+			data_ = nullptr;
+		}
+		size_ = 0;
+	}
+
+	void Close() noexcept {
+		Unmap();
+		if (file_ >= 0) {
+			::close(std::exchange(file_, -1));
+		}
+	}
+#endif
+};
@@ -0,0 +1,280 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "mapped_file.h"
+#include "simd_compare.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Вектор тривиально копируемых элементов, хранящийся прямо в отображённом в память файле.
+// Файл начинается с заголовка (сигнатура, версия формата, размер элемента, размер и вместимость),
+// за которым без всякой сериализации лежат элементы. Open() отображает готовый файл без разбора содержимого,
+// поэтому открытие не зависит от объёма данных. Размер хранится в самом заголовке и в режиме kReadWrite
+// сохраняется в файле при каждом изменении.
+// Формат привязан к представлению Type на текущей платформе (порядок байт, выравнивание).
+// Любая изменяющая операция над вектором в режиме kReadOnly, включая неконстантные operator[], At, begin и end,
+// выбрасывает std::logic_error: читать такой вектор следует через константную ссылку
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+class MappedSimpleVector {
+	static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector stores raw bytes of its elements");
+
+public:
+	using Iterator = Type*;
+	using ConstIterator = const Type*;
+
+	static constexpr std::uint64_t kMagic = 0x524F544345564D53;  // "SMVECTOR"
+	static constexpr std::uint32_t kVersion = 1;
+
+	// Заголовок файла. Элементы начинаются со смещения kDataOffset
+	struct Header {
+		std::uint64_t magic;
+		std::uint32_t version;
+		std::uint32_t element_size;
+		std::uint64_t size;
+		std::uint64_t capacity;
+	};
+
+	static constexpr size_t kDataOffset = 64;
+	static_assert(sizeof(Header) <= kDataOffset && alignof(Type) <= kDataOffset, "Elements must fit after the header");
+
+	MappedSimpleVector() noexcept = default;
+
+	// Создаёт (или перезаписывает) файл path с пустым вектором вместимостью capacity
+	static MappedSimpleVector Create(const std::string& path, size_t capacity = 0) {
+		MappedSimpleVector vector;
+		vector.file_ = MappedFile(path, MapMode::kReadWrite, FileSize(capacity));
+		Header& header = vector.GetHeader();
+		header.magic = kMagic;
+		header.version = kVersion;
+		header.element_size = sizeof(Type);
+		header.size = 0;
+		header.capacity = capacity;
+		return vector;
+	}
+
+	// Отображает существующий файл. Проверяется только заголовок, сами элементы не читаются.
+	// Выбрасывает std::runtime_error, если файл не является вектором из элементов Type
+	static MappedSimpleVector Open(const std::string& path, MapMode mode = MapMode::kReadWrite) {
+		MappedSimpleVector vector;
+		vector.file_ = MappedFile(path, mode);
+		if (vector.file_.GetSize() < kDataOffset) {
+			throw std::runtime_error("MappedSimpleVector: file is too small: " + path);
+		}
+		const Header& header = vector.GetHeader();
+		if (header.magic != kMagic || header.version != kVersion) {
+			throw std::runtime_error("MappedSimpleVector: unknown file format: " + path);
+		}
+		if (header.element_size != sizeof(Type)) {
+			throw std::runtime_error("MappedSimpleVector: element size mismatch: " + path);
+		}
+		if (header.size > header.capacity || FileSize(header.capacity) > vector.file_.GetSize()) {
+			throw std::runtime_error("MappedSimpleVector: corrupted header: " + path);
+		}
+		return vector;
+	}
+
+	MappedSimpleVector(MappedSimpleVector&& other) noexcept = default;
+	MappedSimpleVector& operator=(MappedSimpleVector&& other) noexcept = default;
+
+	// Возвращает количество элементов в массиве
+	size_t GetSize() const noexcept {
+		return IsOpen() ? static_cast<size_t>(GetHeader().size) : 0;
+	}
+
+	// Возвращает вместимость массива
+	size_t GetCapacity() const noexcept {
+		return IsOpen() ? static_cast<size_t>(GetHeader().capacity) : 0;
+	}
+
+	// Сообщает, пустой ли массив
+	bool IsEmpty() const noexcept {
+		return GetSize() == 0;
+	}
+
+	// Сообщает, связан ли вектор с файлом
+	bool IsOpen() const noexcept {
+		return file_.Data() != nullptr;
+	}
+
+	MapMode GetMode() const noexcept {
+		return file_.GetMode();
+	}
+
+	// Возвращает ссылку на элемент с индексом index
+	Type& operator[](size_t index) {
+		assert(index < GetSize());
+		CheckMutableAccess();
+		return Data()[index];
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index
+	const Type& operator[](size_t index) const noexcept {
+		assert(index < GetSize());
+		return Data()[index];
+	}
+
+	// Возвращает ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	Type& At(size_t index) {
+		if (index >= GetSize()) {
+			throw std::out_of_range("Error: out of range");
+		}
+		CheckMutableAccess();
+		return Data()[index];
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	const Type& At(size_t index) const {
+		if (index >= GetSize()) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return Data()[index];
+	}
+
+	Iterator begin() {
+		CheckMutableAccess();
+		return Data();
+	}
+
+	Iterator end() {
+		CheckMutableAccess();
+		return Data() + GetSize();
+	}
+
+	ConstIterator begin() const noexcept {
+		return Data();
+	}
+
+	ConstIterator end() const noexcept {
+		return Data() + GetSize();
+	}
+
+	ConstIterator cbegin() const noexcept {
+		return begin();
+	}
+
+	ConstIterator cend() const noexcept {
+		return end();
+	}
+
+	// Обнуляет размер массива, не изменяя его вместимость
+	void Clear() {
+		CheckWritable();
+		GetHeader().size = 0;
+	}
+
+	// Добавляет элемент в конец вектора. При нехватке места расширяет файл по политике GrowthPolicy
+	void PushBack(const Type& item) {
+		CheckWritable();
+		const size_t size = GetSize();
+		if (size == GetCapacity()) {
+			// item может лежать в этом же файле, а отображение при расширении переезжает
+			const Type copy = item;
+			Grow(std::max(GrowthPolicy::Grow(GetCapacity(), sizeof(Type)), size + 1));
+			Data()[size] = copy;
+		}
+		else {
+			Data()[size] = item;
+		}
+		GetHeader().size = size + 1;
+	}
+
+	// Удаляет последний элемент вектора. Вектор не должен быть пустым
+	void PopBack() {
+		CheckWritable();
+		assert(!IsEmpty());
+		--GetHeader().size;
+	}
+
+	// Резервирует в файле место под new_capacity элементов
+	void Reserve(size_t new_capacity) {
+		CheckWritable();
+		if (new_capacity > GetCapacity()) {
+			Grow(new_capacity);
+		}
+	}
+
+	// Изменяет размер массива. Новые элементы получают значение value
+	void Resize(size_t new_size, const Type& value = Type()) {
+		CheckWritable();
+		const size_t size = GetSize();
+		if (new_size > GetCapacity()) {
+			const Type copy = value;
+			Grow(std::max(new_size, GrowthPolicy::Grow(GetCapacity(), sizeof(Type))));
+			std::fill(Data() + size, Data() + new_size, copy);
+		}
+		else if (new_size > size) {
+			std::fill(Data() + size, Data() + new_size, value);
+		}
+		GetHeader().size = new_size;
+	}
+
+	// Сбрасывает изменения на диск (только в режиме kReadWrite)
+	void Flush() {
+		file_.Flush();
+	}
+
+private:
+	MappedFile file_;
+
+	static size_t FileSize(size_t capacity) {
+		if (capacity > (static_cast<size_t>(-1) - kDataOffset) / sizeof(Type)) {
+			throw std::length_error("MappedSimpleVector: capacity is too large");
+		}
+		return kDataOffset + capacity * sizeof(Type);
+	}
+
+	Header& GetHeader() noexcept {
+		return *reinterpret_cast<Header*>(file_.Data());
+	}
+
+	const Header& GetHeader() const noexcept {
+		return *reinterpret_cast<const Header*>(file_.Data());
+	}
+
+	Type* Data() noexcept {
+		return IsOpen() ? reinterpret_cast<Type*>(file_.Data() + kDataOffset) : nullptr;
+	}
+
+	const Type* Data() const noexcept {
+		return IsOpen() ? reinterpret_cast<const Type*>(file_.Data() + kDataOffset) : nullptr;
+	}
+
+	void CheckWritable() const {
+		if (!IsOpen()) {
+			throw std::logic_error("MappedSimpleVector: no file is open");
+		}
+		if (GetMode() == MapMode::kReadOnly) {
+			throw std::logic_error("MappedSimpleVector: file is opened read-only");
+		}
+	}
+
+	// Неконстантный доступ к элементам: страницы файла в режиме kReadOnly защищены от записи,
+	// и запись через выданную ссылку завершила бы процесс. Пустой вектор без файла доступен
+	void CheckMutableAccess() const {
+		if (IsOpen() && GetMode() == MapMode::kReadOnly) {
+			throw std::logic_error("MappedSimpleVector: file is opened read-only");
+		}
+	}
+
+	// Расширяет файл (или, в режиме kCopyOnWrite, приватную копию) под new_capacity элементов
+	void Grow(size_t new_capacity) {
+		file_.Resize(FileSize(new_capacity));
+		GetHeader().capacity = new_capacity;
+	}
+};
+
+template <typename Type, typename GrowthPolicy>
+inline bool operator==(const MappedSimpleVector<Type, GrowthPolicy>& lhs, const MappedSimpleVector<Type, GrowthPolicy>& rhs) {
+	return simd_compare::Equal(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template <typename Type, typename GrowthPolicy>
+inline bool operator!=(const MappedSimpleVector<Type, GrowthPolicy>& lhs, const MappedSimpleVector<Type, GrowthPolicy>& rhs) {
+	return !(lhs == rhs);
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Аллокатор, берущий каждый блок напрямую у ОС анонимным отображением страниц (mmap, на Windows — VirtualAlloc).
+// Рассчитан на очень большие векторы: под Linux reallocate расширяет блок через mremap, то есть перестраивает
+// таблицу страниц вместо копирования гигабайтов, и старый и новый буферы не держатся в памяти одновременно.
+// SimpleVector вызывает reallocate только для тривиально перемещаемых элементов, остальные переносятся как обычно.
+// Каждый блок занимает не меньше страницы, поэтому для маленьких векторов аллокатор невыгоден.
+// HugePages == true просит ядро подкладывать под блок прозрачные большие страницы (madvise(MADV_HUGEPAGE))
+template <typename Type, bool HugePages = false>
+class MmapAllocator {
+public:
+	using value_type = Type;
+
+	template <typename Other>
+	struct rebind {
+		using other = MmapAllocator<Other, HugePages>;
+	};
+
+	MmapAllocator() noexcept = default;
+
+	template <typename Other>
+	MmapAllocator(const MmapAllocator<Other, HugePages>&) noexcept {
+	}
+
+	Type* allocate(size_t size) {
+		return static_cast<Type*>(Map(ByteSize(size)));
+	}
+
+	void deallocate(Type* raw_ptr, size_t size) noexcept {
+		Unmap(raw_ptr, ByteSize(size));
+	}
+
+	// Переносит блок в отображение под new_size элементов, сохраняя содержимое побайтно.
+	// Под Linux страницы не копируются, а переотображаются по новому адресу
+	Type* reallocate(Type* raw_ptr, size_t old_size, size_t new_size) {
+		const size_t old_bytes = ByteSize(old_size);
+		const size_t new_bytes = ByteSize(new_size);
+		if (old_bytes == new_bytes) {
+			return raw_ptr;
+		}
+#if defined(__linux__)
+		void* new_ptr = mremap(raw_ptr, old_bytes, new_bytes, MREMAP_MAYMOVE);
+		if (new_ptr == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+		Advise(new_ptr, new_bytes);
+		return static_cast<Type*>(new_ptr);
+#else
+		void* new_ptr = Map(new_bytes);
+		std::memcpy(new_ptr, static_cast<const void*>(raw_ptr), old_bytes < new_bytes ? old_bytes : new_bytes);
+		Unmap(raw_ptr, old_bytes);
+		return static_cast<Type*>(new_ptr);
+#endif
+	}
+
+	// Размер страницы ОС. Блоки выделяются кратно ему
+	static size_t PageSize() noexcept {
+#ifdef _WIN32
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		return static_cast<size_t>(info.dwPageSize);
+#else
+		return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+	}
+
+private:
+	// Размер блока под size элементов, округлённый вверх до целого числа страниц
+	static size_t ByteSize(size_t size) {
+		if (size > static_cast<size_t>(-1) / sizeof(Type) - PageSize()) {
+			throw std::bad_array_new_length();
+		}
+		const size_t page = PageSize();
+		return (size * sizeof(Type) + page - 1) / page * page;
+	}
+
+	static void* Map(size_t bytes) {
+#ifdef _WIN32
+		void* raw_ptr = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if (raw_ptr == nullptr) {
+			throw std::bad_alloc();
+		}
+#else
+		void* raw_ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw_ptr == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+		Advise(raw_ptr, bytes);
+#endif
+		return raw_ptr;
+	}
+
+	static void Unmap(void* raw_ptr, [[maybe_unused]] size_t bytes) noexcept {
+#ifdef _WIN32
+		VirtualFree(raw_ptr, 0, MEM_RELEASE);
+#else
+		munmap(raw_ptr, bytes);
+#endif
+	}
+
+	// Подсказка ядру о больших страницах. Ошибка не критична: блок просто останется на обычных страницах
+	static void Advise([[maybe_unused]] void* raw_ptr, [[maybe_unused]] size_t bytes) noexcept {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+		if constexpr (HugePages) {
+			madvise(raw_ptr, bytes, MADV_HUGEPAGE);
+		}
+#endif
+	}
+};
+
+template <typename Type, typename Other, bool HugePages>
+inline bool operator==(const MmapAllocator<Type, HugePages>&, const MmapAllocator<Other, HugePages>&) noexcept {
+	return true;
+}
+
+template <typename Type, typename Other, bool HugePages>
+inline bool operator!=(const MmapAllocator<Type, HugePages>&, const MmapAllocator<Other, HugePages>&) noexcept {
+	return false;
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "simple_vector.h"
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Параллельные алгоритмы над SimpleVector и диапазонами итераторов произвольного доступа.
+// Диапазон режется на порции по grain элементов, которые выполняет WorkStealingPool; вызывающий поток
+// берёт первую порцию себе и затем помогает пулу. Короткие диапазоны обрабатываются в вызывающем потоке.
+// Исключение из пользовательской функции перебрасывается в вызывающий поток после завершения всех порций
+
+struct ParallelOptions {
+	// Элементов в одной задаче. 0 — примерно четыре задачи на поток
+	size_t grain = 0;
+	// Диапазоны короче этого обрабатываются последовательно
+	size_t serial_threshold = size_t(1) << 14;
+	// Пул, на котором выполняются задачи. nullptr — WorkStealingPool::Default()
+	WorkStealingPool* pool = nullptr;
+};
+
+namespace parallel_detail {
+
+	// Разбиение count элементов на порции одинакового размера (последняя может быть короче)
+	struct Chunking {
+		size_t chunk_size = 0;
+		size_t chunk_count = 0;
+	};
+
+	inline WorkStealingPool& GetPool(const ParallelOptions& options) {
+		return options.pool != nullptr ? *options.pool : WorkStealingPool::Default();
+	}
+
+	inline Chunking MakeChunking(size_t count, const ParallelOptions& options) {
+		if (count == 0) {
+			return {};
+		}
+		const size_t threads = GetPool(options).GetThreadCount() + 1;
+		size_t chunk_size = count;
+		if (count >= options.serial_threshold && threads > 1) {
+			chunk_size = options.grain != 0 ? options.grain : std::max<size_t>((count + threads * 4 - 1) / (threads * 4), 1);
+		}
+		return { chunk_size, (count + chunk_size - 1) / chunk_size };
+	}
+
+	// Вызывает body(chunk, begin, end) для каждой порции разбиения chunking диапазона [0, count)
+	template <typename Body>
+	void ForEachChunk(size_t count, const Chunking& chunking, const ParallelOptions& options, Body&& body) {
+		if (chunking.chunk_count <= 1) {
+			if (count != 0) {
+				body(size_t(0), size_t(0), count);
+			}
+			return;
+		}
+		WorkStealingPool& pool = GetPool(options);
+		std::atomic<size_t> remaining(chunking.chunk_count);
+		std::exception_ptr error;
+		std::mutex error_mutex;
+		const auto run = [&](size_t chunk) {
+			const size_t begin = chunk * chunking.chunk_size;
+			const size_t end = std::min(begin + chunking.chunk_size, count);
+			try {
+				body(chunk, begin, end);
+			}
+			catch (...) {
+				std::lock_guard guard(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+			remaining.fetch_sub(1, std::memory_order_acq_rel);
+		};
+
+		size_t submitted = 1;
+		try {
+			for (; submitted < chunking.chunk_count; ++submitted) {
+				pool.Submit([&run, submitted] {
+					run(submitted);
+				});
+			}
+		}
+		catch (...) {
+			// Порции, которые не удалось поставить в очередь, выполняются здесь
+			for (size_t chunk = submitted; chunk < chunking.chunk_count; ++chunk) {
+				run(chunk);
+			}
+		}
+		run(0);
+		while (remaining.load(std::memory_order_acquire) != 0) {
+			if (!pool.RunPendingTask()) {
+				std::this_thread::yield();
+			}
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+	template <typename It>
+	inline constexpr bool kRandomAccess = std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::random_access_iterator_tag>;
+
+}  // namespace parallel_detail
+
+// Вызывает f(element) для каждого элемента [first, last)
+template <typename RandomIt, typename Function>
+void ParallelForEach(RandomIt first, RandomIt last, Function f, const ParallelOptions& options = {}) {
+	static_assert(parallel_detail::kRandomAccess<RandomIt>, "ParallelForEach requires random access iterators");
+	const size_t count = static_cast<size_t>(last - first);
+	parallel_detail::ForEachChunk(count, parallel_detail::MakeChunking(count, options), options, [&](size_t, size_t begin, size_t end) {
+		std::for_each(first + begin, first + end, f);
+	});
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename Function>
+void ParallelForEach(SimpleVector<Type, Alloc, GrowthPolicy>& vector, Function f, const ParallelOptions& options = {}) {
+	ParallelForEach(vector.begin(), vector.end(), std::move(f), options);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename Function>
+void ParallelForEach(const SimpleVector<Type, Alloc, GrowthPolicy>& vector, Function f, const ParallelOptions& options = {}) {
+	ParallelForEach(vector.begin(), vector.end(), std::move(f), options);
+}
+
+// Записывает op(element) для каждого элемента [first, last) в диапазон, начинающийся с d_first.
+// Возвращает итератор за последним записанным элементом
+template <typename RandomIt, typename OutputIt, typename UnaryOperation>
+OutputIt ParallelTransform(RandomIt first, RandomIt last, OutputIt d_first, UnaryOperation op, const ParallelOptions& options = {}) {
+	static_assert(parallel_detail::kRandomAccess<RandomIt> && parallel_detail::kRandomAccess<OutputIt>,
+		"ParallelTransform requires random access iterators");
+	const size_t count = static_cast<size_t>(last - first);
+	parallel_detail::ForEachChunk(count, parallel_detail::MakeChunking(count, options), options, [&](size_t, size_t begin, size_t end) {
+		std::transform(first + begin, first + end, d_first + begin, op);
+	});
+	return d_first + count;
+}
+
+// Заполняет out результатами op для элементов in. Размер out становится равен размеру in
+template <typename Type, typename Alloc, typename GrowthPolicy, typename Result, typename ResultAlloc, typename ResultGrowthPolicy,
+	typename UnaryOperation>
+void ParallelTransform(const SimpleVector<Type, Alloc, GrowthPolicy>& in, SimpleVector<Result, ResultAlloc, ResultGrowthPolicy>& out,
+	UnaryOperation op, const ParallelOptions& options = {}) {
+	out.Resize(in.GetSize());
+	ParallelTransform(in.begin(), in.end(), out.begin(), std::move(op), options);
+}
+
+// Сворачивает [first, last) операцией op, начиная с init. op должна быть ассоциативной: порции сворачиваются
+// независимо, а их итоги объединяются слева направо, так что коммутативность не требуется
+template <typename RandomIt, typename T, typename BinaryOperation>
+T ParallelReduce(RandomIt first, RandomIt last, T init, BinaryOperation op, const ParallelOptions& options = {}) {
+	static_assert(parallel_detail::kRandomAccess<RandomIt>, "ParallelReduce requires random access iterators");
+	const size_t count = static_cast<size_t>(last - first);
+	const parallel_detail::Chunking chunking = parallel_detail::MakeChunking(count, options);
+	if (chunking.chunk_count <= 1) {
+		return std::accumulate(first, last, std::move(init), op);
+	}
+	std::vector<std::optional<T>> partial(chunking.chunk_count);
+	parallel_detail::ForEachChunk(count, chunking, options, [&](size_t chunk, size_t begin, size_t end) {
+		T acc = first[begin];
+		for (size_t i = begin + 1; i < end; ++i) {
+			acc = op(std::move(acc), first[i]);
+		}
+		partial[chunk].emplace(std::move(acc));
+	});
+	for (std::optional<T>& value : partial) {
+		init = op(std::move(init), std::move(*value));
+	}
+	return init;
+}
+
+template <typename RandomIt, typename T>
+T ParallelReduce(RandomIt first, RandomIt last, T init, const ParallelOptions& options = {}) {
+	return ParallelReduce(first, last, std::move(init), std::plus<>(), options);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename T, typename BinaryOperation>
+T ParallelReduce(const SimpleVector<Type, Alloc, GrowthPolicy>& vector, T init, BinaryOperation op, const ParallelOptions& options = {}) {
+	return ParallelReduce(vector.begin(), vector.end(), std::move(init), std::move(op), options);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy, typename T>
+T ParallelReduce(const SimpleVector<Type, Alloc, GrowthPolicy>& vector, T init, const ParallelOptions& options = {}) {
+	return ParallelReduce(vector.begin(), vector.end(), std::move(init), std::plus<>(), options);
+}
+
+// Записывает в d_first префиксные свёртки [first, last) операцией op: d_first[i] = x[0] op ... op x[i].
+// Выполняется в два прохода: сначала итоги порций, затем каждая порция сканируется со своим смещением.
+// op должна быть ассоциативной. Диапазон результата может совпадать с исходным
+template <typename RandomIt, typename OutputIt, typename BinaryOperation>
+OutputIt ParallelInclusiveScan(RandomIt first, RandomIt last, OutputIt d_first, BinaryOperation op, const ParallelOptions& options = {}) {
+	static_assert(parallel_detail::kRandomAccess<RandomIt> && parallel_detail::kRandomAccess<OutputIt>,
+		"ParallelInclusiveScan requires random access iterators");
+	using Value = typename std::iterator_traits<RandomIt>::value_type;
+	const size_t count = static_cast<size_t>(last - first);
+	const parallel_detail::Chunking chunking = parallel_detail::MakeChunking(count, options);
+	if (chunking.chunk_count <= 1) {
+		return std::partial_sum(first, last, d_first, op);
+	}
+
+	// Итог каждой порции, кроме последней: он нужен только следующим
+	std::vector<std::optional<Value>> offsets(chunking.chunk_count);
+	parallel_detail::ForEachChunk(count, chunking, options, [&](size_t chunk, size_t begin, size_t end) {
+		if (chunk + 1 == chunking.chunk_count) {
+			return;
+		}
+		Value acc = first[begin];
+		for (size_t i = begin + 1; i < end; ++i) {
+			acc = op(std::move(acc), first[i]);
+		}
+		offsets[chunk + 1].emplace(std::move(acc));
+	});
+	for (size_t chunk = 2; chunk < chunking.chunk_count; ++chunk) {
+		offsets[chunk].emplace(op(*offsets[chunk - 1], std::move(*offsets[chunk])));
+	}
+	parallel_detail::ForEachChunk(count, chunking, options, [&](size_t chunk, size_t begin, size_t end) {
+		Value acc = chunk == 0 ? Value(first[begin]) : op(*offsets[chunk], first[begin]);
+		d_first[begin] = acc;
+		for (size_t i = begin + 1; i < end; ++i) {
+			acc = op(std::move(acc), first[i]);
+			d_first[i] = acc;
+		}
+	});
+	return d_first + count;
+}
+
+template <typename RandomIt, typename OutputIt>
+OutputIt ParallelInclusiveScan(RandomIt first, RandomIt last, OutputIt d_first, const ParallelOptions& options = {}) {
+	return ParallelInclusiveScan(first, last, d_first, std::plus<>(), options);
+}
+
+// Сканирует вектор на месте
+template <typename Type, typename Alloc, typename GrowthPolicy, typename BinaryOperation = std::plus<>>
+void ParallelInclusiveScan(SimpleVector<Type, Alloc, GrowthPolicy>& vector, BinaryOperation op = {}, const ParallelOptions& options = {}) {
+	ParallelInclusiveScan(vector.begin(), vector.end(), vector.begin(), std::move(op), options);
+}
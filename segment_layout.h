@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Номер старшего единичного бита x. x не должен быть нулём
+inline size_t HighestBit(size_t x) noexcept {
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, static_cast<unsigned long long>(x));
+	return static_cast<size_t>(index);
+#else
+	return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(x)));
+#endif
+}
+
+// Раскладка индексов по сегментам геометрически растущего размера: сегмент k вмещает 2^(FirstSegmentLog + k)
+// элементов и начинается с индекса 2^FirstSegmentLog * (2^k - 1). Сегменты не перевыделяются при росте,
+// поэтому элементы не переезжают, а номер сегмента и смещение в нём вычисляются по старшему биту за O(1)
+template <size_t FirstSegmentLog>
+struct SegmentLayout {
+	static constexpr size_t kFirstSegmentSize = size_t(1) << FirstSegmentLog;
+	// Сегментов хватает на любой индекс типа size_t
+	static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - FirstSegmentLog;
+
+	static size_t SegmentOf(size_t index) noexcept {
+		return HighestBit(index + kFirstSegmentSize) - FirstSegmentLog;
+	}
+
+	static size_t SegmentSize(size_t segment) noexcept {
+		return kFirstSegmentSize << segment;
+	}
+
+	static size_t SegmentStart(size_t segment) noexcept {
+		return (kFirstSegmentSize << segment) - kFirstSegmentSize;
+	}
+
+	static size_t OffsetInSegment(size_t index, size_t segment) noexcept {
+		return index - SegmentStart(segment);
+	}
+};
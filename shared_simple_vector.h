@@ -0,0 +1,324 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+
+// Вектор с копированием при записи (copy-on-write). Копия разделяет с оригиналом один SimpleVector
+// со счётчиком ссылок и создаётся за O(1); глубокое копирование откладывается до первой изменяющей операции
+// над разделённым содержимым. Чтение не копирует никогда.
+// Счётчик атомарный, поэтому копии можно передавать в другие потоки и читать там, пока владелец меняет свою.
+// Один и тот же объект SharedSimpleVector из нескольких потоков одновременно менять нельзя.
+// Неконстантные operator[], At, begin и end тоже считаются изменяющими: ссылки и итераторы, полученные через них,
+// действительны до следующего копирования вектора, и писать через них после копирования нельзя
+template <typename Type, typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SharedSimpleVector {
+public:
+	using Vector = SimpleVector<Type, Alloc, GrowthPolicy>;
+	using Iterator = typename Vector::Iterator;
+	using ConstIterator = typename Vector::ConstIterator;
+
+	SharedSimpleVector() noexcept = default;
+
+	// Создаёт вектор из size элементов, инициализированных значением по умолчанию
+	explicit SharedSimpleVector(size_t size)
+		: SharedSimpleVector(Vector(size)) {
+	}
+
+	// Создаёт вектор из size элементов, инициализированных значением value
+	SharedSimpleVector(size_t size, const Type& value)
+		: SharedSimpleVector(Vector(size, value)) {
+	}
+
+	// Создаёт вектор из std::initializer_list
+	SharedSimpleVector(std::initializer_list<Type> init)
+		: SharedSimpleVector(Vector(init)) {
+	}
+
+	// Забирает содержимое обычного вектора без копирования элементов
+	explicit SharedSimpleVector(Vector&& vector)
+		: block_(new Block(std::move(vector))) {
+	}
+
+	// Конструктор копирования за O(1): содержимое становится общим
+	SharedSimpleVector(const SharedSimpleVector& other) noexcept
+		: block_(other.block_) {
+		if (block_ != nullptr) {
+			block_->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	SharedSimpleVector(SharedSimpleVector&& other) noexcept
+		: block_(std::exchange(other.block_, nullptr)) {
+	}
+
+	SharedSimpleVector& operator=(const SharedSimpleVector& rhs) noexcept {
+		SharedSimpleVector temp(rhs);
+		swap(temp);
+		return *this;
+	}
+
+	SharedSimpleVector& operator=(SharedSimpleVector&& rhs) noexcept {
+		SharedSimpleVector temp(std::move(rhs));
+		swap(temp);
+		return *this;
+	}
+
+	~SharedSimpleVector() {
+		Release();
+	}
+
+	size_t GetSize() const noexcept {
+		return block_ != nullptr ? block_->vector.GetSize() : 0;
+	}
+
+	size_t GetCapacity() const noexcept {
+		return block_ != nullptr ? block_->vector.GetCapacity() : 0;
+	}
+
+	bool IsEmpty() const noexcept {
+		return GetSize() == 0;
+	}
+
+	// Сколько объектов SharedSimpleVector разделяют это содержимое. У пустого вектора без памяти — 0
+	size_t GetUseCount() const noexcept {
+		return block_ != nullptr ? block_->refs.load(std::memory_order_acquire) : 0;
+	}
+
+	// Константный доступ к разделяемому вектору, без копирования
+	const Vector& GetVector() const noexcept {
+		return block_ != nullptr ? block_->vector : EmptyVector();
+	}
+
+	const Type& operator[](size_t index) const noexcept {
+		return GetVector()[index];
+	}
+
+	// Отделяет содержимое, если оно общее
+	Type& operator[](size_t index) {
+		return Mutable()[index];
+	}
+
+	const Type& At(size_t index) const {
+		return GetVector().At(index);
+	}
+
+	Type& At(size_t index) {
+		GetVector().At(index);
+		return Mutable()[index];
+	}
+
+	ConstIterator begin() const noexcept {
+		return GetVector().begin();
+	}
+
+	ConstIterator end() const noexcept {
+		return GetVector().end();
+	}
+
+	ConstIterator cbegin() const noexcept {
+		return begin();
+	}
+
+	ConstIterator cend() const noexcept {
+		return end();
+	}
+
+	Iterator begin() {
+		return Mutable().begin();
+	}
+
+	Iterator end() {
+		return Mutable().end();
+	}
+
+	// Общее содержимое не копируется, а просто отпускается
+	void Clear() noexcept {
+		if (IsUnique()) {
+			block_->vector.Clear();
+		}
+		else {
+			Release();
+		}
+	}
+
+	void PushBack(const Type& item) {
+		EmplaceBack(item);
+	}
+
+	void PushBack(Type&& item) {
+		EmplaceBack(std::move(item));
+	}
+
+	// При отделении сразу резервирует место под новый элемент, чтобы не копировать элементы дважды.
+	// args могут ссылаться на элементы этого же вектора: старое содержимое отпускается только после вставки
+	template <typename... Args>
+	Type& EmplaceBack(Args&&... args) {
+		if (IsUnique()) {
+			return block_->vector.EmplaceBack(std::forward<Args>(args)...);
+		}
+		SharedSimpleVector copy(CopyWithCapacity(GrownCapacity(GetSize() + 1)));
+		Type& result = copy.block_->vector.EmplaceBack(std::forward<Args>(args)...);
+		swap(copy);
+		return result;
+	}
+
+	void PopBack() {
+		assert(!IsEmpty());
+		Mutable().PopBack();
+	}
+
+	Iterator Insert(ConstIterator pos, const Type& value) {
+		return Emplace(pos, value);
+	}
+
+	Iterator Insert(ConstIterator pos, Type&& value) {
+		return Emplace(pos, std::move(value));
+	}
+
+	// pos может указывать в общее содержимое: после отделения он переносится в новую копию
+	template <typename... Args>
+	Iterator Emplace(ConstIterator pos, Args&&... args) {
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		if (IsUnique()) {
+			return block_->vector.Emplace(pos, std::forward<Args>(args)...);
+		}
+		SharedSimpleVector copy(CopyWithCapacity(GrownCapacity(GetSize() + 1)));
+		Vector& vector = copy.block_->vector;
+		vector.Emplace(vector.cbegin() + index, std::forward<Args>(args)...);
+		swap(copy);
+		return block_->vector.begin() + index;
+	}
+
+	Iterator Erase(ConstIterator pos) {
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		Vector& vector = Mutable();
+		return vector.Erase(vector.cbegin() + index);
+	}
+
+	void Reserve(size_t new_capacity) {
+		if (new_capacity <= GetCapacity()) {
+			return;
+		}
+		if (IsUnique()) {
+			block_->vector.Reserve(new_capacity);
+			return;
+		}
+		SharedSimpleVector copy(CopyWithCapacity(new_capacity));
+		swap(copy);
+	}
+
+	// Общее содержимое отделяется копированием только тех элементов, что останутся после изменения размера
+	void Resize(size_t new_size) {
+		if (new_size == GetSize()) {
+			return;
+		}
+		if (!IsUnique()) {
+			SharedSimpleVector copy(CopyWithCapacity(new_size, std::min(new_size, GetSize())));
+			swap(copy);
+		}
+		block_->vector.Resize(new_size);
+	}
+
+	void swap(SharedSimpleVector& other) noexcept {
+		std::swap(block_, other.block_);
+	}
+
+private:
+	struct Block {
+		explicit Block(Vector&& vector)
+			: vector(std::move(vector)) {
+		}
+
+		std::atomic<size_t> refs{ 1 };
+		Vector vector;
+	};
+
+	Block* block_ = nullptr;
+
+	static const Vector& EmptyVector() noexcept {
+		static const Vector empty;
+		return empty;
+	}
+
+	// acquire: изменения, сделанные через отпущенные копии до их разрушения, видны единственному владельцу
+	bool IsUnique() const noexcept {
+		return block_ != nullptr && block_->refs.load(std::memory_order_acquire) == 1;
+	}
+
+	void Release() noexcept {
+		if (block_ != nullptr && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			delete block_;
+		}
+		block_ = nullptr;
+	}
+
+	// Вместимость копии, в которую нужно поместить required элементов. Если их больше текущей вместимости,
+	// копия сразу растёт по GrowthPolicy, как вырос бы сам SimpleVector, и следующая вставка не копирует всё заново
+	size_t GrownCapacity(size_t required) const noexcept {
+		const size_t capacity = GetCapacity();
+		if (required <= capacity) {
+			return capacity;
+		}
+		return std::max(GrowthPolicy::Grow(capacity, sizeof(Type)), required);
+	}
+
+	// Глубокая копия содержимого с вместимостью не меньше capacity
+	SharedSimpleVector CopyWithCapacity(size_t capacity) const {
+		return CopyWithCapacity(capacity, GetSize());
+	}
+
+	// Глубокая копия первых count элементов с вместимостью не меньше capacity
+	SharedSimpleVector CopyWithCapacity(size_t capacity, size_t count) const {
+		const Vector& source = GetVector();
+		Vector vector(::Reserve(std::max(capacity, count)),
+			std::allocator_traits<Alloc>::select_on_container_copy_construction(source.GetAllocator()));
+		vector.Append(source.begin(), source.begin() + count);
+		return SharedSimpleVector(std::move(vector));
+	}
+
+	// Делает содержимое единственным, копируя его при необходимости, и возвращает его для изменения
+	Vector& Mutable() {
+		if (!IsUnique()) {
+			SharedSimpleVector copy(CopyWithCapacity(GetSize()));
+			swap(copy);
+		}
+		return block_->vector;
+	}
+};
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator==(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return lhs.GetVector() == rhs.GetVector();
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator!=(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator<(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return lhs.GetVector() < rhs.GetVector();
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator<=(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator>(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+inline bool operator>=(const SharedSimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SharedSimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(lhs < rhs);
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMPLE_VECTOR_SIMD_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Сравнение массивов арифметических элементов для операторов сравнения векторов.
+// Целые сравниваются побайтно (memcmp либо поиск первого различающегося байта SSE2/AVX2),
+// float и double — векторными сравнениями с той же семантикой NaN, что у поэлементного кода:
+// в Equal NaN не равен ничему, а в Less пара с NaN считается эквивалентной и пропускается, как в
+// std::lexicographical_compare. AVX2 выбирается во время выполнения, если его поддерживает процессор.
+// Остальные типы сравниваются std::equal и std::lexicographical_compare
+namespace simd_compare {
+
+	// Какие пары элементов ищет поиск по float/double
+	enum class FloatMismatch {
+		kNotEqual,   // !(a == b): первый элемент, нарушающий равенство (в том числе NaN)
+		kOrdered,    // a < b || b < a: первый элемент, решающий лексикографическое сравнение
+	};
+
+	inline unsigned CountTrailingZeros(unsigned mask) noexcept {
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return static_cast<unsigned>(index);
+#else
+		return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+	}
+
+	// Возвращает индекс первого байта, в котором lhs и rhs различаются, или bytes
+	inline size_t FindByteMismatchScalar(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+		size_t i = 0;
+		while (i < bytes && lhs[i] == rhs[i]) {
+			++i;
+		}
+		return i;
+	}
+
+	template <FloatMismatch Mode, typename Float>
+	bool IsFloatMismatch(Float lhs, Float rhs) noexcept {
+		if constexpr (Mode == FloatMismatch::kNotEqual) {
+			return !(lhs == rhs);
+		}
+		else {
+			return lhs < rhs || rhs < lhs;
+		}
+	}
+
+	template <FloatMismatch Mode, typename Float>
+	size_t FindFloatMismatchScalar(const Float* lhs, const Float* rhs, size_t count) noexcept {
+		size_t i = 0;
+		while (i < count && !IsFloatMismatch<Mode>(lhs[i], rhs[i])) {
+			++i;
+		}
+		return i;
+	}
+
+#ifdef SIMPLE_VECTOR_SIMD_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMPLE_VECTOR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMPLE_VECTOR_TARGET_AVX2
+#endif
+
+	inline bool HasAvx2() noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		static const bool has_avx2 = __builtin_cpu_supports("avx2");
+#else
+		static const bool has_avx2 = [] {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) {
+				return false;
+			}
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}();
+#endif
+		return has_avx2;
+	}
+
+	inline size_t FindByteMismatchSse2(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+		size_t i = 0;
+		for (; i + 16 <= bytes; i += 16) {
+			const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+			const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xFFFFu;
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindByteMismatchScalar(lhs + i, rhs + i, bytes - i);
+	}
+
+	SIMPLE_VECTOR_TARGET_AVX2 inline size_t FindByteMismatchAvx2(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+		size_t i = 0;
+		for (; i + 32 <= bytes; i += 32) {
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+			const unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindByteMismatchSse2(lhs + i, rhs + i, bytes - i);
+	}
+
+	template <FloatMismatch Mode>
+	size_t FindFloatMismatchSse2(const float* lhs, const float* rhs, size_t count) noexcept {
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128 a = _mm_loadu_ps(lhs + i);
+			const __m128 b = _mm_loadu_ps(rhs + i);
+			__m128 diff = _mm_cmpneq_ps(a, b);
+			if constexpr (Mode == FloatMismatch::kOrdered) {
+				diff = _mm_and_ps(diff, _mm_cmpord_ps(a, b));
+			}
+			const unsigned mask = static_cast<unsigned>(_mm_movemask_ps(diff));
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindFloatMismatchScalar<Mode>(lhs + i, rhs + i, count - i);
+	}
+
+	template <FloatMismatch Mode>
+	size_t FindFloatMismatchSse2(const double* lhs, const double* rhs, size_t count) noexcept {
+		size_t i = 0;
+		for (; i + 2 <= count; i += 2) {
+			const __m128d a = _mm_loadu_pd(lhs + i);
+			const __m128d b = _mm_loadu_pd(rhs + i);
+			__m128d diff = _mm_cmpneq_pd(a, b);
+			if constexpr (Mode == FloatMismatch::kOrdered) {
+				diff = _mm_and_pd(diff, _mm_cmpord_pd(a, b));
+			}
+			const unsigned mask = static_cast<unsigned>(_mm_movemask_pd(diff));
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindFloatMismatchScalar<Mode>(lhs + i, rhs + i, count - i);
+	}
+
+	// _CMP_NEQ_UQ истинно и для NaN, _CMP_NEQ_OQ — только для упорядоченных различных значений
+	template <FloatMismatch Mode>
+	constexpr int kAvxPredicate = Mode == FloatMismatch::kNotEqual ? _CMP_NEQ_UQ : _CMP_NEQ_OQ;
+
+	template <FloatMismatch Mode>
+	SIMPLE_VECTOR_TARGET_AVX2 size_t FindFloatMismatchAvx2(const float* lhs, const float* rhs, size_t count) noexcept {
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256 diff = _mm256_cmp_ps(_mm256_loadu_ps(lhs + i), _mm256_loadu_ps(rhs + i), kAvxPredicate<Mode>);
+			const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(diff));
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindFloatMismatchSse2<Mode>(lhs + i, rhs + i, count - i);
+	}
+
+	template <FloatMismatch Mode>
+	SIMPLE_VECTOR_TARGET_AVX2 size_t FindFloatMismatchAvx2(const double* lhs, const double* rhs, size_t count) noexcept {
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m256d diff = _mm256_cmp_pd(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i), kAvxPredicate<Mode>);
+			const unsigned mask = static_cast<unsigned>(_mm256_movemask_pd(diff));
+			if (mask != 0) {
+				return i + CountTrailingZeros(mask);
+			}
+		}
+		return i + FindFloatMismatchSse2<Mode>(lhs + i, rhs + i, count - i);
+	}
+
+	inline size_t FindByteMismatch(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+		return HasAvx2() ? FindByteMismatchAvx2(lhs, rhs, bytes) : FindByteMismatchSse2(lhs, rhs, bytes);
+	}
+
+	template <FloatMismatch Mode, typename Float>
+	size_t FindFloatMismatch(const Float* lhs, const Float* rhs, size_t count) noexcept {
+		return HasAvx2() ? FindFloatMismatchAvx2<Mode>(lhs, rhs, count) : FindFloatMismatchSse2<Mode>(lhs, rhs, count);
+	}
+
+#else
+
+	inline size_t FindByteMismatch(const unsigned char* lhs, const unsigned char* rhs, size_t bytes) noexcept {
+		return FindByteMismatchScalar(lhs, rhs, bytes);
+	}
+
+	template <FloatMismatch Mode, typename Float>
+	size_t FindFloatMismatch(const Float* lhs, const Float* rhs, size_t count) noexcept {
+		return FindFloatMismatchScalar<Mode>(lhs, rhs, count);
+	}
+
+#endif
+
+	// Целые без битов заполнения: равенство значений совпадает с равенством байтов
+	template <typename Type>
+	inline constexpr bool kBytewise = std::is_integral_v<Type> && std::has_unique_object_representations_v<Type>;
+
+	template <typename Type>
+	inline constexpr bool kSimdFloat = std::is_same_v<Type, float> || std::is_same_v<Type, double>;
+
+	// Равны ли массивы [lhs, lhs + lhs_size) и [rhs, rhs + rhs_size)
+	template <typename Type>
+	bool Equal(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+		if (lhs_size != rhs_size) {
+			return false;
+		}
+		if (lhs_size == 0) {
+			return true;
+		}
+		if constexpr (kBytewise<Type>) {
+			return std::memcmp(lhs, rhs, lhs_size * sizeof(Type)) == 0;
+		}
+		else if constexpr (kSimdFloat<Type>) {
+			return FindFloatMismatch<FloatMismatch::kNotEqual>(lhs, rhs, lhs_size) == lhs_size;
+		}
+		else {
+			return std::equal(lhs, lhs + lhs_size, rhs);
+		}
+	}
+
+	// Лексикографически ли меньше массив lhs, чем rhs
+	template <typename Type>
+	bool Less(const Type* lhs, size_t lhs_size, const Type* rhs, size_t rhs_size) {
+		const size_t common = std::min(lhs_size, rhs_size);
+		if constexpr (kBytewise<Type> || kSimdFloat<Type>) {
+			size_t index = common;
+			if (common != 0) {
+				if constexpr (kBytewise<Type>) {
+					// Первый различающийся байт лежит в первом различающемся элементе
+					index = FindByteMismatch(reinterpret_cast<const unsigned char*>(lhs), reinterpret_cast<const unsigned char*>(rhs),
+						common * sizeof(Type)) / sizeof(Type);
+				}
+				else {
+					index = FindFloatMismatch<FloatMismatch::kOrdered>(lhs, rhs, common);
+				}
+			}
+			if (index < common) {
+				return lhs[index] < rhs[index];
+			}
+			return lhs_size < rhs_size;
+		}
+		else {
+			return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);
+		}
+	}
+
+}  // namespace simd_compare
@@ -1,126 +1,214 @@
 #pragma once
 
+#include "aligned_allocator.h"
+#include "arena_allocator.h"
 #include "array_ptr.h"
-
+#include "buffer_cache.h"
+#include "constexpr_support.h"
+#include "fast_fill.h"
+#include "growth_policy.h"
+#include "simd_compare.h"
+#include "vector_stats.h"
+
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
 
 class ReserveProxyObj {
 public:
-	ReserveProxyObj(size_t size) {
+	constexpr ReserveProxyObj(size_t size) {
 		size_ = size;
 	}
-	size_t GetSize() {
+	constexpr size_t GetSize() {
 		return size_;
 	}
 private:
 	size_t size_ = 0;
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+constexpr ReserveProxyObj Reserve(size_t capacity_to_reserve) {
 	return ReserveProxyObj(capacity_to_reserve);
 }
 
-template <typename Type>
-class SimpleVector {
+// Категория итератора It, если It вообще является итератором
+template <typename It, typename = void>
+struct IsInputIterator : std::false_type {
+};
+
+template <typename It>
+struct IsInputIterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+	: std::is_convertible<typename std::iterator_traits<It>::iterator_category, std::input_iterator_tag> {
+};
+
+template <typename It>
+inline constexpr bool IsForwardIterator = std::is_convertible_v<typename std::iterator_traits<It>::iterator_category, std::forward_iterator_tag>;
+
+// Счётчики VectorStatsRecorder ведутся, только если определён SIMPLE_VECTOR_STATS (см. vector_stats.h)
+template <typename Type, typename Alloc = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class SimpleVector : private VectorStatsRecorder {
+	using AllocTraits = std::allocator_traits<Alloc>;
+
+	// Элементы сдвигаются и переезжают при росте через memmove (или realloc аллокатора), см. RelocateBytes
+	static constexpr bool kRelocateBitwise = is_trivially_relocatable_v<Type> && std::is_nothrow_move_constructible_v<Type>;
+
 public:
 	using Iterator = Type*;
 	using ConstIterator = const Type*;
+	using allocator_type = Alloc;
+
+	// Выравнивание начала буфера в байтах. Соблюдается на всех путях роста: новый блок всегда берётся у Alloc
+	static constexpr size_t kAlignment = ArrayPtr<Type, Alloc>::kAlignment;
+	using growth_policy = GrowthPolicy;
 
-	SimpleVector() noexcept = default;
+	// Возвращает счётчики выделений, копирований и перемещений этого вектора (нули без SIMPLE_VECTOR_STATS)
+	using VectorStatsRecorder::GetStats;
+
+	SimpleVector() noexcept(noexcept(Alloc())) = default;
+
+	SIMPLE_VECTOR_CONSTEXPR explicit SimpleVector(const Alloc& alloc) noexcept
+		: array_(alloc) {
+	}
 
 	// Создаёт вектор из size элементов, инициализированных значением по умолчанию
-	explicit
-		SimpleVector(size_t size) : array_(size) {
+	SIMPLE_VECTOR_CONSTEXPR explicit
+		SimpleVector(size_t size, const Alloc& alloc = Alloc()) : array_(size, alloc) {
+		RecordInitialBlock();
+		ValueConstruct(array_.Get(), size);
 		size_ = size;
 		capacity_ = size;
 	}
 
-	// Конструктор сразу резервирует память
-	SimpleVector(ReserveProxyObj other) : array_(other.GetSize()) {
+	// Конструктор сразу резервирует память. Элементы не конструируются
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(ReserveProxyObj other, const Alloc& alloc = Alloc()) : array_(other.GetSize(), alloc) {
+		RecordInitialBlock();
 		size_ = 0;
 		capacity_ = other.GetSize();
 	}
 
 	// Создаёт вектор из size элементов, инициализированных значением value
-	SimpleVector(size_t size, const Type& value) : array_(size) {
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(size_t size, const Type& value, const Alloc& alloc = Alloc()) : array_(size, alloc) {
+		RecordInitialBlock();
+		FillConstruct(array_.Get(), size, value);
 		size_ = size;
 		capacity_ = size;
-		std::fill(begin(), end(), value);
 	}
 
 	// Создаёт вектор из std::initializer_list
-	SimpleVector(std::initializer_list<Type> init) : array_(init.size()) {
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(std::initializer_list<Type> init, const Alloc& alloc = Alloc()) : array_(init.size(), alloc) {
+		RecordInitialBlock();
+		CopyConstruct(init.begin(), init.end(), array_.Get());
 		size_ = init.size();
 		capacity_ = init.size();
-		std::copy(init.begin(), init.end(), &array_[0]);
 	}
 
-	// Конструктор копирования
-	SimpleVector(const SimpleVector& other) : array_(other.capacity_) {
-		SimpleVector<Type> temp(other.capacity_);
-		temp.size_ = other.size_;
-		std::copy(other.begin(), other.end(), temp.begin());
-		swap(temp);
+	// Конструктор копирования. Аллокатор выбирается через select_on_container_copy_construction
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other)
+		: SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
 	}
 
-	// Конструктор перемещения
-	SimpleVector(SimpleVector&& other) : array_(other.capacity_) {
-		swap(other);
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(const SimpleVector& other, const Alloc& alloc) : array_(other.size_, alloc) {
+		RecordInitialBlock();
+		CopyConstruct(other.begin(), other.end(), array_.Get());
+		size_ = other.size_;
+		capacity_ = other.size_;
+	}
+
+	// Конструктор перемещения. Аллокатор переезжает вместе с памятью
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector(SimpleVector&& other) noexcept
+		: array_(std::move(other.array_)) {
+		size_ = std::exchange(other.size_, 0);
+		capacity_ = std::exchange(other.capacity_, 0);
 	}
 
 	// Оператор присваивания
-	SimpleVector& operator=(const SimpleVector& rhs) {
-		if (this != &rhs && !rhs.IsEmpty()) {
-			SimpleVector<Type> temp(rhs);
-			std::copy(rhs.begin(), rhs.end(), temp.begin());
-			swap(temp);
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(const SimpleVector& rhs) {
+		if (this != &rhs) {
+			if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+				SimpleVector temp(rhs, rhs.GetAllocator());
+				array_.SwapAllocator(temp.array_);
+				TakeStorage(temp);
+			}
+			else {
+				SimpleVector temp(rhs, GetAllocator());
+				TakeStorage(temp);
+			}
 		}
 		return *this;
 	}
 
-	// Оператор перемещения
-	SimpleVector& operator=(SimpleVector&& rhs) {
-		if (this != &rhs && !rhs.IsEmpty()) {
-			SimpleVector<Type> temp(rhs);
-			std::copy(rhs.begin(), rhs.end(), temp.begin());
-			swap(temp);
+	// Оператор перемещения. Если аллокатор не распространяется при перемещении и не равен аллокатору rhs,
+	// элементы перемещаются по одному в память собственного аллокатора
+	SIMPLE_VECTOR_CONSTEXPR SimpleVector& operator=(SimpleVector&& rhs) noexcept(
+		AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+		if (this == &rhs) {
+			return *this;
+		}
+		if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+			SimpleVector temp(std::move(rhs));
+			array_.SwapAllocator(temp.array_);
+			TakeStorage(temp);
+		}
+		else {
+			if (GetAllocator() == rhs.GetAllocator()) {
+				SimpleVector temp(std::move(rhs));
+				TakeStorage(temp);
+			}
+			else {
+				SimpleVector temp(::Reserve(rhs.size_), GetAllocator());
+				CopyConstruct(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()), temp.array_.Get());
+				temp.size_ = rhs.size_;
+				TakeStorage(temp);
+				rhs.Clear();
+			}
 		}
 		return *this;
 	}
 
+	SIMPLE_VECTOR_CONSTEXPR ~SimpleVector() {
+		Destroy(begin(), end());
+	}
+
+	// Возвращает копию аллокатора
+	SIMPLE_VECTOR_CONSTEXPR Alloc GetAllocator() const noexcept {
+		return array_.GetAllocator();
+	}
+
 	// Возвращает количество элементов в массиве
-	size_t GetSize() const noexcept {
+	SIMPLE_VECTOR_CONSTEXPR size_t GetSize() const noexcept {
 		return size_;
 	}
 
 	// Возвращает вместимость массива
-	size_t GetCapacity() const noexcept {
+	SIMPLE_VECTOR_CONSTEXPR size_t GetCapacity() const noexcept {
 		return capacity_;
 	}
 
 	// Сообщает, пустой ли массив
-	bool IsEmpty() const noexcept {
+	SIMPLE_VECTOR_CONSTEXPR bool IsEmpty() const noexcept {
 		return size_ == 0;
 	}
 
 	// Возвращает ссылку на элемент с индексом index
-	Type& operator[](size_t index) noexcept {
-		assert(index <= capacity_);
+	SIMPLE_VECTOR_CONSTEXPR Type& operator[](size_t index) noexcept {
+		assert(index < size_);
 		return array_[index];
 	}
 
 	// Возвращает константную ссылку на элемент с индексом index
-	const Type& operator[](size_t index) const noexcept {
-		assert(index <= capacity_);
+	SIMPLE_VECTOR_CONSTEXPR const Type& operator[](size_t index) const noexcept {
+		assert(index < size_);
 		return array_[index];
 	}
 
 	// Возвращает константную ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
-	Type& At(size_t index) {
+	SIMPLE_VECTOR_CONSTEXPR Type& At(size_t index) {
 		if (index >= size_) {
 			throw std::out_of_range("Error: out of range");
 		}
@@ -130,7 +218,7 @@ public:
 	}
 
 	// Возвращает константную ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
-	const Type& At(size_t index) const {
+	SIMPLE_VECTOR_CONSTEXPR const Type& At(size_t index) const {
 		if (index >= size_) {
 			throw std::out_of_range("Error: out of range");
 		}
@@ -139,234 +227,347 @@ public:
 		}
 	}
 
-	// Обнуляет размер массива, не изменяя его вместимость
-	void Clear() noexcept {
+	// Разрушает все элементы. Вместимость не меняется, если политика роста не требует автоматического ужатия
+	SIMPLE_VECTOR_CONSTEXPR void Clear() noexcept {
+		Destroy(begin(), end());
 		size_ = 0;
+		MaybeAutoShrink();
 	}
 
 	// Возвращает итератор на начало массива. Для пустого массива может быть равен (или не равен) nullptr
-	Iterator begin() noexcept {
-		//return &array_[0];
+	SIMPLE_VECTOR_CONSTEXPR Iterator begin() noexcept {
 		return array_.Get();
 	}
 
 	// Возвращает итератор на элемент, следующий за последним. Для пустого массива может быть равен (или не равен) nullptr
-	Iterator end() noexcept {
-		//return &array_[size_];
+	SIMPLE_VECTOR_CONSTEXPR Iterator end() noexcept {
 		return array_.Get() + size_;
 	}
 
 	// Возвращает константный итератор на начало массива. Для пустого массива может быть равен (или не равен) nullptr
-	ConstIterator begin() const noexcept {
-		//return &array_[0];
+	SIMPLE_VECTOR_CONSTEXPR ConstIterator begin() const noexcept {
 		return array_.Get();
 	}
 
 	// Возвращает итератор на элемент, следующий за последним. Для пустого массива может быть равен (или не равен) nullptr
-	ConstIterator end() const noexcept {
-		//return &array_[size_];
+	SIMPLE_VECTOR_CONSTEXPR ConstIterator end() const noexcept {
 		return array_.Get() + size_;
-
 	}
 
 	// Возвращает константный итератор на начало массива. Для пустого массива может быть равен (или не равен) nullptr
-	ConstIterator cbegin() const noexcept {
-		//	return &array_[0];
+	SIMPLE_VECTOR_CONSTEXPR ConstIterator cbegin() const noexcept {
 		return array_.Get();
 	}
 
 	// Возвращает итератор на элемент, следующий за последним. Для пустого массива может быть равен (или не равен) nullptr
-	ConstIterator cend() const noexcept {
-		//return &array_[size_];
+	SIMPLE_VECTOR_CONSTEXPR ConstIterator cend() const noexcept {
 		return array_.Get() + size_;
-
 	}
 
-	Iterator Erase(ConstIterator pos) {
-		size_t index = 0;
-		Type* it = begin();
-		while (it != pos) {
-			it++;
-			index++;
+	// Удаляет элемент в позиции pos, сдвигая хвост на его место без перевыделения памяти
+	SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator pos) {
+		assert(pos >= begin() && pos < end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		Type* it = begin() + index;
+
+		if constexpr (kRelocateBitwise) {
+			Destroy(it, it + 1);
+			RelocateBytes(it, it + 1, size_ - index - 1);
+			RecordRelocation((size_ - index - 1) * sizeof(Type));
+		}
+		else {
+			std::move(it + 1, end(), it);
+			RecordMoves(size_ - index - 1);
+			Destroy(end() - 1, end());
+		}
+		--size_;
+		return it;
+	}
+
+	// Удаляет элементы [first, last) одним сдвигом хвоста. Возвращает итератор на элемент, следовавший за удалёнными
+	SIMPLE_VECTOR_CONSTEXPR Iterator Erase(ConstIterator first, ConstIterator last) {
+		assert(first >= begin() && first <= last && last <= end());
+		const size_t index = static_cast<size_t>(first - cbegin());
+		const size_t count = static_cast<size_t>(last - first);
+		Type* it = begin() + index;
+		if (count == 0) {
+			return it;
 		}
 
-		SimpleVector<Type> temp(capacity_);
-		std::copy(std::make_move_iterator(begin()), std::make_move_iterator(it), temp.begin());
-		std::copy(std::make_move_iterator(it + 1), std::make_move_iterator(end()), &temp[index]);
-		array_.swap(temp.array_);
-		size_--;
-		return &array_[index];
+		if constexpr (kRelocateBitwise) {
+			Destroy(it, it + count);
+			RelocateBytes(it, it + count, size_ - index - count);
+			RecordRelocation((size_ - index - count) * sizeof(Type));
+		}
+		else {
+			std::move(it + count, end(), it);
+			RecordMoves(size_ - index - count);
+			Destroy(end() - count, end());
+		}
+		size_ -= count;
+		return it;
 	}
 
 	// Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение
-	// Если перед вставкой значения вектор был заполнен полностью, вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-	Iterator Insert(ConstIterator pos, const Type& value) {
-
-		bool pos_in_range = false;
-		size_t index = 0;
-		Type* it = begin();
-		while (it != end() + 1) {
-			if (it == pos) {
-				pos_in_range = true;
-				break;
+	// Если перед вставкой значения вектор был заполнен полностью, вместимость растёт по политике роста: по умолчанию вдвое, а для вектора вместимостью 0 становится равной 1
+	SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, const Type& value) {
+		return Emplace(pos, value);
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, Type&& value) {
+		return Emplace(pos, std::move(value));
+	}
+
+	// Вставляет элементы [first, last) в позицию pos. Для прямых итераторов — не больше одного перевыделения
+	// и один сдвиг хвоста. Итераторы не должны указывать внутрь этого вектора
+	template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+	SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+		assert(pos >= begin() && pos <= end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		if constexpr (IsForwardIterator<InputIt>) {
+			const size_t count = static_cast<size_t>(std::distance(first, last));
+			return InsertN(index, count, [&](Type* dest) {
+				CopyConstruct(first, last, dest);
+			});
+		}
+		else {
+			// Длина однопроходного диапазона неизвестна: дописываем в конец и поворачиваем на место
+			const size_t old_size = size_;
+			for (; first != last; ++first) {
+				EmplaceBack(*first);
 			}
-			it++;
-			index++;
+			std::rotate(begin() + index, begin() + old_size, end());
+			return begin() + index;
 		}
-		assert(pos_in_range);
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, std::initializer_list<Type> init) {
+		return Insert(pos, init.begin(), init.end());
+	}
+
+	// Вставляет count копий value в позицию pos
+	SIMPLE_VECTOR_CONSTEXPR Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
+		assert(pos >= begin() && pos <= end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		// value может ссылаться на элемент этого же вектора, который сдвинется раньше, чем будет скопирован
+		const Type copy(value);
+		return InsertN(index, count, [&](Type* dest) {
+			FillConstruct(dest, count, copy);
+		});
+	}
+
+	// Дописывает элементы [first, last) в конец вектора
+	template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+	SIMPLE_VECTOR_CONSTEXPR void Append(InputIt first, InputIt last) {
+		Insert(cend(), first, last);
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void Append(std::initializer_list<Type> init) {
+		Insert(cend(), init.begin(), init.end());
+	}
 
-		if (size_ < capacity_) {
-			SimpleVector<Type> temp(capacity_);
-			temp.size_ = size_;
-			std::copy(begin(), it, temp.begin());
-			temp.array_[index] = value;
-			std::copy(it, end(), &temp[index + 1]);
-			array_.swap(temp.array_);
-			size_++;
+	// Дописывает count копий value в конец вектора
+	SIMPLE_VECTOR_CONSTEXPR void Append(size_t count, const Type& value) {
+		Insert(cend(), count, value);
+	}
+
+	// Дописывает count элементов, которые fill(dest) записывает прямо в неинициализированную память за концом
+	// вектора, без предварительного заполнения нулями (например, читает их из потока). Вместимость растёт
+	// по политике роста. Если fill бросает исключение, размер не меняется
+	template <typename Fill>
+	SIMPLE_VECTOR_CONSTEXPR void AppendUninitialized(size_t count, Fill fill) {
+		static_assert(std::is_trivially_copyable_v<Type>, "AppendUninitialized requires a trivially copyable type");
+		InsertN(size_, count, fill);
+	}
+
+	// Заменяет содержимое элементами [first, last). Память перевыделяется, только если их больше вместимости
+	template <typename InputIt, std::enable_if_t<IsInputIterator<InputIt>::value, int> = 0>
+	SIMPLE_VECTOR_CONSTEXPR void Assign(InputIt first, InputIt last) {
+		if constexpr (IsForwardIterator<InputIt>) {
+			const size_t count = static_cast<size_t>(std::distance(first, last));
+			if (count > capacity_) {
+				SimpleVector temp(::Reserve(count), GetAllocator());
+				CopyConstruct(first, last, temp.begin());
+				temp.size_ = count;
+				TakeStorage(temp);
+				return;
+			}
+			if (count <= size_) {
+				Type* new_end = std::copy(first, last, begin());
+				RecordTransfers<InputIt>(count);
+				Destroy(new_end, end());
+			}
+			else {
+				InputIt mid = std::next(first, static_cast<std::ptrdiff_t>(size_));
+				std::copy(first, mid, begin());
+				RecordTransfers<InputIt>(size_);
+				CopyConstruct(mid, last, end());
+			}
+			size_ = count;
 		}
 		else {
-			if (capacity_ == 0) {
-				ArrayPtr<Type> arr_ptr(1);
-				array_.swap(arr_ptr);
-				capacity_ = 1;
-				size_ = 0;
-				it = begin();
+			Clear();
+			for (; first != last; ++first) {
+				EmplaceBack(*first);
 			}
-
-			SimpleVector<Type> temp(capacity_ * 2);
-			temp.size_ = size_;
-			std::copy(begin(), it, temp.begin());
-			temp[index] = value;
-			std::copy(it, end(), &temp[index + 1]);
-			array_.swap(temp.array_);
-			std::swap(capacity_, temp.capacity_);
-			size_++;
 		}
-		return &array_[index];
 	}
 
-	Iterator Insert(ConstIterator pos, Type&& value) {
+	SIMPLE_VECTOR_CONSTEXPR void Assign(std::initializer_list<Type> init) {
+		Assign(init.begin(), init.end());
+	}
 
-		bool pos_in_range = false;
-		size_t index = 0;
-		Type* it = begin();
-		while (it != end() + 1) {
-			if (it == pos) {
-				pos_in_range = true;
-				break;
-			}
-			it++;
-			index++;
+	// Заменяет содержимое count копиями value
+	SIMPLE_VECTOR_CONSTEXPR void Assign(size_t count, const Type& value) {
+		if (count > capacity_) {
+			SimpleVector temp(count, value, GetAllocator());
+			TakeStorage(temp);
+			return;
 		}
-		assert(pos_in_range);
-
-		if (size_ < capacity_) {
-			SimpleVector<Type> temp(capacity_);
-			temp.size_ = size_;
-			std::copy(std::make_move_iterator(begin()), std::make_move_iterator(it), temp.begin());
-			temp.array_[index] = std::move(value);
-			std::copy(std::make_move_iterator(it), std::make_move_iterator(end()), &temp[index + 1]);
-			array_.swap(temp.array_);
-			size_++;
+		const Type copy(value);
+		if (count <= size_) {
+			std::fill(begin(), begin() + count, copy);
+			RecordCopies(count);
+			Destroy(begin() + count, end());
 		}
 		else {
-			if (capacity_ == 0) {
-				ArrayPtr<Type> arr_ptr(1);
-				array_.swap(arr_ptr);
-				capacity_ = 1;
-				size_ = 0;
-				it = begin();
-			}
-
-			SimpleVector<Type> temp(capacity_ * 2);
-			temp.size_ = size_;
-			std::copy(std::make_move_iterator(begin()), std::make_move_iterator(it), temp.begin());
-			temp[index] = std::move(value);
-			std::copy(std::make_move_iterator(it), std::make_move_iterator(end()), &temp[index + 1]);
-			array_.swap(temp.array_);
-			std::swap(capacity_, temp.capacity_);
-			size_++;
+			std::fill(begin(), end(), copy);
+			RecordCopies(size_);
+			FillConstruct(end(), count - size_, copy);
 		}
-		return &array_[index];
+		size_ = count;
 	}
 
-	// "Удаляет" последний элемент вектора. Вектор не должен быть пустым
-	void PopBack() noexcept {
+	// Удаляет последний элемент вектора. Вектор не должен быть пустым
+	SIMPLE_VECTOR_CONSTEXPR void PopBack() noexcept {
 		assert(!IsEmpty());
-		size_--;
+		--size_;
+		Destroy(end(), end() + 1);
+		MaybeAutoShrink();
 	}
 
-	// Добавляет элемент в конец вектора. При нехватке места увеличивает вдвое вместимость вектора
-	void PushBack(const Type& item) {
-		if (capacity_ == 0) {
-			ArrayPtr<Type> arr_ptr(1);
-			array_.swap(arr_ptr);
-			capacity_ = 1;
-			size_ = 0;
-		}
+	// Добавляет элемент в конец вектора. При нехватке места увеличивает вместимость по политике роста (по умолчанию вдвое)
+	SIMPLE_VECTOR_CONSTEXPR void PushBack(const Type& item) {
+		EmplaceBack(item);
+	}
 
-		auto old_size = size_;
-		if (size_ >= capacity_) {
-			Resize(capacity_ * 2);
-			size_ = old_size;
+	SIMPLE_VECTOR_CONSTEXPR void PushBack(Type&& item) {
+		EmplaceBack(std::move(item));
+	}
+
+	// Конструирует элемент из args прямо в памяти вектора после последнего элемента. Возвращает ссылку на него
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR Type& EmplaceBack(Args&&... args) {
+		if (size_ == capacity_ && kRelocateBitwise) {
+			// Перенос блока может освободить старую память, а args могут ссылаться на элементы этого же вектора
+			Type temp = MakeValue(std::forward<Args>(args)...);
+			Reallocate(NextCapacity());
+			ConstructAt(end(), std::move(temp));
+			RecordMoves(1);
+		}
+		else if (size_ == capacity_) {
+			ArrayPtr<Type, Alloc> temp = AllocateBlock(NextCapacity());
+			// Новый элемент конструируется до переноса старых: args могут ссылаться на элементы этого же вектора
+			ConstructAt(temp.Get() + size_, std::forward<Args>(args)...);
+			try {
+				RelocateTo(begin(), end(), temp.Get());
+			}
+			catch (...) {
+				Destroy(temp.Get() + size_, temp.Get() + size_ + 1);
+				throw;
+			}
+			Destroy(begin(), end());
+			AdoptBlock(temp);
+		}
+		else {
+			ConstructAt(end(), std::forward<Args>(args)...);
 		}
-		array_[size_] = item;
-		size_++;
+		++size_;
+		return *(end() - 1);
 	}
 
-	void PushBack(Type&& item) {
-		if (capacity_ == 0) {
-			ArrayPtr<Type> arr_ptr(1);
-			array_.swap(arr_ptr);
-			capacity_ = 1;
-			size_ = 0;
+	// Конструирует элемент из args в позиции pos. Возвращает итератор на него
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR Iterator Emplace(ConstIterator pos, Args&&... args) {
+		assert(pos >= begin() && pos <= end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+
+		if (size_ == capacity_ && !kRelocateBitwise) {
+			InsertWithReallocation(index, std::forward<Args>(args)...);
+			return begin() + index;
+		}
+		if (index == size_) {
+			EmplaceBack(std::forward<Args>(args)...);
+			return begin() + index;
 		}
 
-		auto old_size = size_;
-		if (size_ >= capacity_) {
-			Resize(capacity_ * 2);
-			size_ = old_size;
+		// args могут ссылаться на элементы этого же вектора, поэтому сначала конструируем временный объект
+		Type temp = MakeValue(std::forward<Args>(args)...);
+		if (size_ == capacity_) {
+			Reallocate(NextCapacity());
+		}
+		Type* it = begin() + index;
+		if constexpr (kRelocateBitwise) {
+			RelocateBytes(it + 1, it, size_ - index);
+			ConstructAt(it, std::move(temp));
+			RecordRelocation((size_ - index) * sizeof(Type));
+			RecordMoves(1);
+		}
+		else {
+			Type* last = end() - 1;
+			ConstructAt(end(), std::move(*last));
+			std::move_backward(it, last, end());
+			*it = std::move(temp);
+			RecordMoves(size_ - index + 1);
 		}
-		array_[size_] = std::move(item);
-		size_++;
+		++size_;
+		return it;
 	}
 
-	void Reserve(size_t new_capacity) {
-		if (capacity_ == 0) {
-			ArrayPtr<Type> new_arr(new_capacity);
-			array_.swap(new_arr);
-			size_ = 0;
-			capacity_ = new_capacity;
-		}
+	// Резервирует память под new_capacity элементов. Новые слоты не конструируются
+	SIMPLE_VECTOR_CONSTEXPR void Reserve(size_t new_capacity) {
 		if (new_capacity > capacity_) {
-			capacity_ = new_capacity;
+			Reallocate(new_capacity);
 		}
 	}
 
-	// Изменяет размер массива. При увеличении размера новые элементы получают значение по умолчанию для типа Type
-	void Resize(size_t new_size) {
-		if (new_size <= size_) {
-			size_ = new_size;
+	// Уменьшает вместимость до размера. Пустой вектор освобождает память целиком
+	SIMPLE_VECTOR_CONSTEXPR void ShrinkToFit() {
+		if (capacity_ == size_) {
+			return;
 		}
-		else if (new_size <= capacity_) {
-			std::fill(end(), &array_[new_size], 0);
-			size_ = new_size;
+		if (size_ == 0) {
+			ArrayPtr<Type, Alloc> empty(array_.GetAllocator());
+			AdoptBlock(empty);
+			return;
 		}
-		else if (new_size > capacity_) {
+		Reallocate(size_);
+	}
 
-			ArrayPtr<Type> temp(new_size);
-			std::copy(std::make_move_iterator(begin()), std::make_move_iterator(end()), temp.Get());
-			array_.swap(temp);
+	// Изменяет размер массива. При увеличении размера новые элементы получают значение по умолчанию для типа Type
+	SIMPLE_VECTOR_CONSTEXPR void Resize(size_t new_size) {
+		if (new_size <= size_) {
+			Destroy(begin() + new_size, end());
 			size_ = new_size;
-			capacity_ = new_size;
+			return;
+		}
+		if (new_size > capacity_) {
+			Reallocate(new_size);
 		}
+		ValueConstruct(end(), new_size - size_);
+		size_ = new_size;
 	}
 
-	// Обменивает значение с другим вектором
-	void swap(SimpleVector& other) noexcept {
-		array_.swap(other.array_);
-		std::swap(size_, other.size_);
-		std::swap(capacity_, other.capacity_);
+	// Обменивает значение с другим вектором. Аллокаторы обмениваются, только если этого требует
+	// propagate_on_container_swap, иначе они должны быть равны
+	SIMPLE_VECTOR_CONSTEXPR void swap(SimpleVector& other) noexcept {
+		if constexpr (AllocTraits::propagate_on_container_swap::value) {
+			array_.SwapAllocator(other.array_);
+		}
+		else {
+			assert(GetAllocator() == other.GetAllocator());
+		}
+		SwapStorage(other);
 	}
 
 	// Показать содержимое массива
@@ -379,7 +580,7 @@ public:
 	}
 
 private:
-	ArrayPtr<Type> array_;
+	ArrayPtr<Type, Alloc> array_;
 	size_t size_ = 0;
 	size_t capacity_ = 0;
 
@@ -388,34 +589,365 @@ private:
 			throw std::out_of_range("index exceed array capacity");
 		}
 	}
+
+	// Обменивается памятью, размером и вместимостью, не трогая аллокаторы
+	SIMPLE_VECTOR_CONSTEXPR void SwapStorage(SimpleVector& other) noexcept {
+		array_.swap(other.array_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+	// Забирает память временного вектора temp, собранного от имени этого, вместе с его счётчиками
+	SIMPLE_VECTOR_CONSTEXPR void TakeStorage(SimpleVector& temp) noexcept {
+		SwapStorage(temp);
+		AbsorbStats(temp);
+		if (temp.array_) {
+			RecordDeallocation();
+		}
+	}
+
+	// Выделяет блок под capacity элементов тем же аллокатором
+	SIMPLE_VECTOR_CONSTEXPR ArrayPtr<Type, Alloc> AllocateBlock(size_t capacity) {
+		ArrayPtr<Type, Alloc> block(capacity, array_.GetAllocator());
+		RecordAllocation(capacity * sizeof(Type));
+		return block;
+	}
+
+	// Делает block текущей памятью вектора. Элементы в него уже перенесены, прежний блок остаётся в block
+	SIMPLE_VECTOR_CONSTEXPR void AdoptBlock(ArrayPtr<Type, Alloc>& block) noexcept {
+		array_.swap(block);
+		if (block) {
+			RecordDeallocation();
+		}
+		RecordCapacity(capacity_, array_.GetSize());
+		capacity_ = array_.GetSize();
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordInitialBlock() noexcept {
+		if (array_) {
+			RecordAllocation(array_.GetSize() * sizeof(Type));
+			RecordCapacity(0, array_.GetSize());
+		}
+	}
+
+	// Учитывает count копирований или перемещений в зависимости от того, что отдаёт разыменование InputIt
+	template <typename InputIt>
+	SIMPLE_VECTOR_CONSTEXPR void RecordTransfers(size_t count) noexcept {
+		if constexpr (std::is_rvalue_reference_v<typename std::iterator_traits<InputIt>::reference>) {
+			RecordMoves(count);
+		}
+		else {
+			RecordCopies(count);
+		}
+	}
+
+	// Вместимость, до которой растёт заполненный вектор. По умолчанию 0 -> 1, далее вдвое
+	SIMPLE_VECTOR_CONSTEXPR size_t NextCapacity() const noexcept {
+		return std::max(GrowthPolicy::Grow(capacity_, sizeof(Type)), capacity_ + 1);
+	}
+
+	// Ужимает память, если этого требует политика. Неудача выделения памяти не страшна: вектор остаётся как есть
+	SIMPLE_VECTOR_CONSTEXPR void MaybeAutoShrink() noexcept {
+		if constexpr (GrowthPolicy::kAutoShrink) {
+			const size_t new_capacity = std::max(GrowthPolicy::Shrink(capacity_, size_), size_);
+			if (new_capacity >= capacity_) {
+				return;
+			}
+			try {
+				if (new_capacity == 0) {
+					ShrinkToFit();
+				}
+				else {
+					Reallocate(new_capacity);
+				}
+			}
+			catch (...) {
+			}
+		}
+	}
+
+	// Конструирует объект в сырой памяти через аллокатор вектора. Агрегаты без подходящего
+	// конструктора инициализируются списком
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR void ConstructAt(Type* dest, Args&&... args) {
+		if constexpr (std::is_constructible_v<Type, Args...>) {
+			AllocTraits::construct(array_.GetAllocator(), dest, std::forward<Args>(args)...);
+		}
+		else {
+			::new (static_cast<void*>(dest)) Type{ std::forward<Args>(args)... };
+		}
+	}
+
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR static Type MakeValue(Args&&... args) {
+		if constexpr (std::is_constructible_v<Type, Args...>) {
+			return Type(std::forward<Args>(args)...);
+		}
+		else {
+			return Type{ std::forward<Args>(args)... };
+		}
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void Destroy(Type* first, Type* last) noexcept {
+		for (; first != last; ++first) {
+			AllocTraits::destroy(array_.GetAllocator(), first);
+		}
+	}
+
+	// Конструирует в dest count объектов из args. При исключении разрушает уже созданные
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR void ConstructN(Type* dest, size_t count, const Args&... args) {
+		size_t i = 0;
+		try {
+			for (; i < count; ++i) {
+				ConstructAt(dest + i, args...);
+			}
+		}
+		catch (...) {
+			Destroy(dest, dest + i);
+			throw;
+		}
+	}
+
+	// Арифметические элементы заполняются через fast_fill: memset, векторные и потоковые записи, несколько потоков
+	SIMPLE_VECTOR_CONSTEXPR void ValueConstruct(Type* dest, size_t count) {
+		if constexpr (fast_fill::kSupported<Type>) {
+			if (!IsConstantEvaluated()) {
+				fast_fill::Fill(dest, count, Type());
+				return;
+			}
+		}
+		ConstructN(dest, count);
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void FillConstruct(Type* dest, size_t count, const Type& value) {
+		if constexpr (fast_fill::kSupported<Type>) {
+			if (!IsConstantEvaluated()) {
+				fast_fill::Fill(dest, count, value);
+			}
+			else {
+				ConstructN(dest, count, value);
+			}
+		}
+		else {
+			ConstructN(dest, count, value);
+		}
+		RecordCopies(count);
+	}
+
+	// Конструирует в dest копии (или перемещённые значения для move_iterator) элементов [first, last)
+	template <typename InputIt>
+	SIMPLE_VECTOR_CONSTEXPR Type* CopyConstruct(InputIt first, InputIt last, Type* dest) {
+		Type* current = dest;
+		try {
+			for (; first != last; ++first, ++current) {
+				ConstructAt(current, *first);
+			}
+		}
+		catch (...) {
+			Destroy(dest, current);
+			throw;
+		}
+		RecordTransfers<InputIt>(static_cast<size_t>(current - dest));
+		return current;
+	}
+
+	// Переносит живые элементы [first, last) в сырую память dest. Копирует вместо перемещения,
+	// только если перемещение может бросить исключение, а копирование доступно
+	SIMPLE_VECTOR_CONSTEXPR void RelocateTo(Type* first, Type* last, Type* dest) {
+		if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+			CopyConstruct(std::make_move_iterator(first), std::make_move_iterator(last), dest);
+		}
+		else {
+			CopyConstruct(first, last, dest);
+		}
+	}
+
+	// Переносит элементы в новый блок вместимостью new_capacity
+	// Тривиально перемещаемые элементы переносятся побайтно, а при поддержке аллокатора — через reallocate
+	SIMPLE_VECTOR_CONSTEXPR void Reallocate(size_t new_capacity) {
+		if constexpr (kRelocateBitwise) {
+			RecordAllocation(new_capacity * sizeof(Type));
+			if (array_) {
+				RecordDeallocation();
+			}
+			array_.Relocate(new_capacity, size_);
+			RecordRelocation(size_ * sizeof(Type));
+			RecordCapacity(capacity_, new_capacity);
+			capacity_ = new_capacity;
+		}
+		else {
+			ArrayPtr<Type, Alloc> temp = AllocateBlock(new_capacity);
+			RelocateTo(begin(), end(), temp.Get());
+			Destroy(begin(), end());
+			AdoptBlock(temp);
+		}
+	}
+
+	// Освобождает место под count элементов в позиции index (не больше одного перевыделения и одного сдвига хвоста)
+	// и конструирует их через fill(dest). fill сам разрушает созданное, если бросает исключение
+	template <typename Fill>
+	SIMPLE_VECTOR_CONSTEXPR Iterator InsertN(size_t index, size_t count, Fill fill) {
+		if (count == 0) {
+			return begin() + index;
+		}
+		if (size_ + count > capacity_) {
+			ArrayPtr<Type, Alloc> temp = AllocateBlock(std::max(NextCapacity(), size_ + count));
+			Type* dest = temp.Get();
+			// Новые элементы конструируются до переноса старых, пока источник гарантированно цел
+			fill(dest + index);
+			if constexpr (kRelocateBitwise) {
+				RelocateBytes(dest, begin(), index);
+				RelocateBytes(dest + index + count, begin() + index, size_ - index);
+				RecordRelocation(size_ * sizeof(Type));
+			}
+			else {
+				try {
+					RelocateTo(begin(), begin() + index, dest);
+				}
+				catch (...) {
+					Destroy(dest + index, dest + index + count);
+					throw;
+				}
+				try {
+					RelocateTo(begin() + index, end(), dest + index + count);
+				}
+				catch (...) {
+					Destroy(dest, dest + index + count);
+					throw;
+				}
+				Destroy(begin(), end());
+			}
+			AdoptBlock(temp);
+		}
+		else {
+			Type* pos = begin() + index;
+			const size_t tail = size_ - index;
+			if constexpr (kRelocateBitwise) {
+				RelocateBytes(pos + count, pos, tail);
+				RecordRelocation(tail * sizeof(Type));
+				try {
+					fill(pos);
+				}
+				catch (...) {
+					RelocateBytes(pos, pos + count, tail);
+					throw;
+				}
+			}
+			else {
+				ShiftTail(index, count);
+				try {
+					fill(pos);
+				}
+				catch (...) {
+					// Возвращаем хвост на место, закрывая дыру
+					for (size_t i = index; i < size_; ++i) {
+						ConstructAt(begin() + i, std::move(begin()[i + count]));
+						Destroy(begin() + i + count, begin() + i + count + 1);
+					}
+					throw;
+				}
+			}
+		}
+		size_ += count;
+		return begin() + index;
+	}
+
+	// Переносит хвост [index, size_) на count позиций вправо, оставляя на его месте сырую память.
+	// Если перемещение бросит исключение, ещё не перенесённые элементы теряются, но вектор остаётся согласованным
+	SIMPLE_VECTOR_CONSTEXPR void ShiftTail(size_t index, size_t count) {
+		size_t i = size_;
+		try {
+			while (i > index) {
+				--i;
+				ConstructAt(begin() + i + count, std::move(begin()[i]));
+				Destroy(begin() + i, begin() + i + 1);
+			}
+			RecordMoves(size_ - index);
+		}
+		catch (...) {
+			Destroy(begin() + i + 1 + count, begin() + size_ + count);
+			size_ = i + 1;
+			throw;
+		}
+	}
+
+	// Вставка в заполненный вектор: элементы переносятся в новый блок вокруг вставляемого значения
+	template <typename... Args>
+	SIMPLE_VECTOR_CONSTEXPR void InsertWithReallocation(size_t index, Args&&... args) {
+		ArrayPtr<Type, Alloc> temp = AllocateBlock(NextCapacity());
+		ConstructAt(temp.Get() + index, std::forward<Args>(args)...);
+		try {
+			RelocateTo(begin(), begin() + index, temp.Get());
+		}
+		catch (...) {
+			Destroy(temp.Get() + index, temp.Get() + index + 1);
+			throw;
+		}
+		try {
+			RelocateTo(begin() + index, end(), temp.Get() + index + 1);
+		}
+		catch (...) {
+			Destroy(temp.Get(), temp.Get() + index + 1);
+			throw;
+		}
+		Destroy(begin(), end());
+		AdoptBlock(temp);
+		++size_;
+	}
 };
 
-template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+namespace pmr {
+	// SimpleVector, получающий память от std::pmr::memory_resource
+	template <typename Type>
+	using SimpleVector = ::SimpleVector<Type, std::pmr::polymorphic_allocator<Type>>;
 }
 
-template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return !std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+// SimpleVector, берущий память из Arena: рост оставляет старые блоки в арене, а освобождается всё разом
+// в Arena::Reset(). Создаётся от арены: ArenaSimpleVector<int> v(arena)
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+using ArenaSimpleVector = SimpleVector<Type, ArenaAllocator<Type>, GrowthPolicy>;
+
+// SimpleVector, переиспользующий освобождённые буферы через кэш потока (см. BufferCache)
+template <typename Type, typename GrowthPolicy = DoublingGrowth>
+using CachedSimpleVector = SimpleVector<Type, CachingAllocator<Type>, GrowthPolicy>;
+
+// SimpleVector, буфер которого выровнен по границе Alignment байт (по умолчанию по строке кэша)
+template <typename Type, size_t Alignment = 64, typename GrowthPolicy = DoublingGrowth>
+using AlignedSimpleVector = SimpleVector<Type, AlignedAllocator<Type, Alignment>, GrowthPolicy>;
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator==(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	if (IsConstantEvaluated()) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	return simd_compare::Equal(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
 }
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator!=(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator<(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	if (IsConstantEvaluated()) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	return simd_compare::Less(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return !std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator<=(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(rhs < lhs);
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator>(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return rhs < lhs;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-	return !std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Alloc, typename GrowthPolicy>
+SIMPLE_VECTOR_CONSTEXPR inline bool operator>=(const SimpleVector<Type, Alloc, GrowthPolicy>& lhs, const SimpleVector<Type, Alloc, GrowthPolicy>& rhs) {
+	return !(lhs < rhs);
 }
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Двоичный формат SimpleVector. Поток начинается с заголовка (сигнатура, версия, размер элемента),
+// за которым идут блоки: количество элементов (uint64) и сами элементы. Блок с количеством 0 завершает поток.
+// Save пишет один блок, SimpleVectorWriter — столько, сколько раз его вызвали, а читаются оба одинаково.
+// Числа и элементы пишутся в представлении текущей платформы (порядок байт, размеры типов)
+
+// Кодек элемента. Для тривиально копируемых типов kBulk == true: блок элементов читается и пишется
+// одним вызовом read/write прямо из буфера вектора. Для остальных типов нужна специализация
+// с методами Write(std::ostream&, const Type&) и Type Read(std::istream&)
+template <typename Type, typename = void>
+struct BinaryCodec {
+};
+
+template <typename Type>
+struct BinaryCodec<Type, std::enable_if_t<std::is_trivially_copyable_v<Type>>> {
+	static constexpr bool kBulk = true;
+};
+
+namespace simple_vector_io {
+
+	inline constexpr std::uint64_t kMagic = 0x4E49425643455653;  // "SVECVBIN"
+	inline constexpr std::uint32_t kVersion = 1;
+
+	// Сколько элементов за раз добавляется в вектор при чтении: повреждённое количество в блоке
+	// не должно приводить к попытке выделить гигантский буфер до того, как данные кончатся
+	inline constexpr size_t kReadSlice = size_t(1) << 16;
+
+	template <typename Codec, typename = void>
+	struct IsBulk : std::false_type {
+	};
+
+	template <typename Codec>
+	struct IsBulk<Codec, std::void_t<decltype(Codec::kBulk)>> : std::bool_constant<Codec::kBulk> {
+	};
+
+	inline void WriteBytes(std::ostream& out, const void* data, size_t bytes) {
+		out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+		if (!out) {
+			throw std::runtime_error("SimpleVector: write failed");
+		}
+	}
+
+	inline void ReadBytes(std::istream& in, void* data, size_t bytes) {
+		in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+		if (static_cast<size_t>(in.gcount()) != bytes) {
+			throw std::runtime_error("SimpleVector: unexpected end of stream");
+		}
+	}
+
+	template <typename Value>
+	void WriteValue(std::ostream& out, const Value& value) {
+		WriteBytes(out, &value, sizeof(value));
+	}
+
+	template <typename Value>
+	Value ReadValue(std::istream& in) {
+		Value value;
+		ReadBytes(in, &value, sizeof(value));
+		return value;
+	}
+
+	// Размер элемента в заголовке: для поэлементных кодеков 0, так как длина записи у каждого своя
+	template <typename Type, typename Codec>
+	constexpr std::uint32_t ElementSize() {
+		return IsBulk<Codec>::value ? static_cast<std::uint32_t>(sizeof(Type)) : 0;
+	}
+
+}  // namespace simple_vector_io
+
+// Строки пишутся как длина (uint64) и символы
+template <>
+struct BinaryCodec<std::string> {
+	static void Write(std::ostream& out, const std::string& value) {
+		simple_vector_io::WriteValue<std::uint64_t>(out, value.size());
+		simple_vector_io::WriteBytes(out, value.data(), value.size());
+	}
+
+	static std::string Read(std::istream& in) {
+		const auto size = simple_vector_io::ReadValue<std::uint64_t>(in);
+		std::string value;
+		// Строка растёт порциями: длина из повреждённого потока не должна выделять память сразу
+		while (value.size() < size) {
+			const size_t old_size = value.size();
+			const size_t portion = static_cast<size_t>(std::min<std::uint64_t>(size - old_size, simple_vector_io::kReadSlice));
+			value.resize(old_size + portion);
+			simple_vector_io::ReadBytes(in, value.data() + old_size, portion);
+		}
+		return value;
+	}
+};
+
+// Пишет вектор в поток блоками произвольного размера. Поток завершается вызовом Finish
+// (или деструктором, который не сообщает об ошибках записи)
+template <typename Type, typename Codec = BinaryCodec<Type>>
+class SimpleVectorWriter {
+public:
+	explicit SimpleVectorWriter(std::ostream& out)
+		: out_(out) {
+		simple_vector_io::WriteValue(out_, simple_vector_io::kMagic);
+		simple_vector_io::WriteValue(out_, simple_vector_io::kVersion);
+		simple_vector_io::WriteValue(out_, simple_vector_io::ElementSize<Type, Codec>());
+	}
+
+	SimpleVectorWriter(const SimpleVectorWriter&) = delete;
+	SimpleVectorWriter& operator=(const SimpleVectorWriter&) = delete;
+
+	~SimpleVectorWriter() {
+		try {
+			Finish();
+		}
+		catch (...) {
+		}
+	}
+
+	// Пишет блок из count элементов, начиная с first
+	void Write(const Type* first, size_t count) {
+		assert(!finished_);
+		if (count == 0) {
+			return;
+		}
+		simple_vector_io::WriteValue<std::uint64_t>(out_, count);
+		if constexpr (simple_vector_io::IsBulk<Codec>::value) {
+			simple_vector_io::WriteBytes(out_, first, count * sizeof(Type));
+		}
+		else {
+			for (const Type* it = first; it != first + count; ++it) {
+				Codec::Write(out_, *it);
+			}
+		}
+	}
+
+	// Пишет все элементы вектора одним блоком
+	template <typename Alloc, typename GrowthPolicy>
+	void Write(const SimpleVector<Type, Alloc, GrowthPolicy>& chunk) {
+		Write(chunk.begin(), chunk.GetSize());
+	}
+
+	// Завершает поток. Повторный вызов ничего не делает
+	void Finish() {
+		if (!finished_) {
+			finished_ = true;
+			simple_vector_io::WriteValue<std::uint64_t>(out_, 0);
+			out_.flush();
+		}
+	}
+
+private:
+	std::ostream& out_;
+	bool finished_ = false;
+};
+
+// Читает поток, записанный Save или SimpleVectorWriter, порциями в переиспользуемый вектор,
+// так что объём памяти ограничен размером порции, а не размером данных.
+// Ошибки формата и обрыв потока сообщаются исключением std::runtime_error
+template <typename Type, typename Codec = BinaryCodec<Type>>
+class SimpleVectorReader {
+public:
+	explicit SimpleVectorReader(std::istream& in)
+		: in_(in) {
+		const auto magic = simple_vector_io::ReadValue<std::uint64_t>(in_);
+		const auto version = simple_vector_io::ReadValue<std::uint32_t>(in_);
+		const auto element_size = simple_vector_io::ReadValue<std::uint32_t>(in_);
+		if (magic != simple_vector_io::kMagic || version != simple_vector_io::kVersion) {
+			throw std::runtime_error("SimpleVector: unknown binary format");
+		}
+		if (element_size != simple_vector_io::ElementSize<Type, Codec>()) {
+			throw std::runtime_error("SimpleVector: element size mismatch");
+		}
+	}
+
+	// Заменяет содержимое chunk следующими не более чем max_elements элементами. Вместимость chunk
+	// сохраняется, поэтому при повторных вызовах память не перевыделяется. Возвращает false, если поток кончился
+	template <typename Alloc, typename GrowthPolicy>
+	bool ReadChunk(SimpleVector<Type, Alloc, GrowthPolicy>& chunk, size_t max_elements) {
+		assert(max_elements > 0);
+		chunk.Clear();
+		ReadInto(chunk, max_elements);
+		return !chunk.IsEmpty();
+	}
+
+	// Дописывает в конец out не более max_elements элементов. Возвращает, сколько дописано
+	template <typename Alloc, typename GrowthPolicy>
+	size_t ReadInto(SimpleVector<Type, Alloc, GrowthPolicy>& out, size_t max_elements = std::numeric_limits<size_t>::max()) {
+		size_t total = 0;
+		while (total < max_elements && NextBlock()) {
+			const size_t count = static_cast<size_t>(std::min<std::uint64_t>(block_left_, max_elements - total));
+			if constexpr (simple_vector_io::IsBulk<Codec>::value) {
+				for (size_t done = 0; done < count;) {
+					// Вместимость растёт геометрически, а байты читаются сразу в хвост без обнуления
+					const size_t slice = std::min(count - done, simple_vector_io::kReadSlice);
+					out.AppendUninitialized(slice, [&](Type* dest) {
+						simple_vector_io::ReadBytes(in_, dest, slice * sizeof(Type));
+					});
+					done += slice;
+				}
+			}
+			else {
+				for (size_t i = 0; i < count; ++i) {
+					out.PushBack(Codec::Read(in_));
+				}
+			}
+			block_left_ -= count;
+			total += count;
+		}
+		return total;
+	}
+
+private:
+	std::istream& in_;
+	std::uint64_t block_left_ = 0;
+	bool finished_ = false;
+
+	// Переходит к следующему непустому блоку, если текущий дочитан. Возвращает false в конце потока
+	bool NextBlock() {
+		while (block_left_ == 0) {
+			if (finished_) {
+				return false;
+			}
+			block_left_ = simple_vector_io::ReadValue<std::uint64_t>(in_);
+			finished_ = block_left_ == 0;
+		}
+		return true;
+	}
+};
+
+// Сохраняет вектор в поток в двоичном формате
+template <typename Codec, typename Type, typename Alloc, typename GrowthPolicy>
+void Save(std::ostream& out, const SimpleVector<Type, Alloc, GrowthPolicy>& vector) {
+	SimpleVectorWriter<Type, Codec> writer(out);
+	writer.Write(vector);
+	writer.Finish();
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+void Save(std::ostream& out, const SimpleVector<Type, Alloc, GrowthPolicy>& vector) {
+	Save<BinaryCodec<Type>>(out, vector);
+}
+
+// Заменяет содержимое vector данными из потока. Если чтение не удалось, vector не меняется
+template <typename Codec, typename Type, typename Alloc, typename GrowthPolicy>
+void Load(std::istream& in, SimpleVector<Type, Alloc, GrowthPolicy>& vector) {
+	SimpleVector<Type, Alloc, GrowthPolicy> temp(vector.GetAllocator());
+	SimpleVectorReader<Type, Codec> reader(in);
+	reader.ReadInto(temp);
+	vector.swap(temp);
+}
+
+template <typename Type, typename Alloc, typename GrowthPolicy>
+void Load(std::istream& in, SimpleVector<Type, Alloc, GrowthPolicy>& vector) {
+	Load<BinaryCodec<Type>>(in, vector);
+}
@@ -0,0 +1,410 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "simple_vector.h"
+#include "simd_compare.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// Вектор с тем же интерфейсом, что и SimpleVector, хранящий до N элементов прямо в объекте.
+// Куча (ArrayPtr) используется, только когда элементов становится больше N
+template <typename Type, size_t N>
+class SmallSimpleVector {
+	static_assert(N > 0, "Inline capacity must be positive");
+
+public:
+	using Iterator = Type*;
+	using ConstIterator = const Type*;
+
+	SmallSimpleVector() noexcept = default;
+
+	// Создаёт вектор из size элементов, инициализированных значением по умолчанию
+	explicit SmallSimpleVector(size_t size) {
+		Reserve(size);
+		std::uninitialized_value_construct_n(data_, size);
+		size_ = size;
+	}
+
+	// Конструктор сразу резервирует память. Элементы не конструируются
+	SmallSimpleVector(ReserveProxyObj other) {
+		Reserve(other.GetSize());
+	}
+
+	// Создаёт вектор из size элементов, инициализированных значением value
+	SmallSimpleVector(size_t size, const Type& value) {
+		Reserve(size);
+		std::uninitialized_fill_n(data_, size, value);
+		size_ = size;
+	}
+
+	// Создаёт вектор из std::initializer_list
+	SmallSimpleVector(std::initializer_list<Type> init) {
+		Reserve(init.size());
+		std::uninitialized_copy(init.begin(), init.end(), data_);
+		size_ = init.size();
+	}
+
+	// Конструктор копирования
+	SmallSimpleVector(const SmallSimpleVector& other) {
+		Reserve(other.size_);
+		std::uninitialized_copy(other.begin(), other.end(), data_);
+		size_ = other.size_;
+	}
+
+	// Конструктор перемещения. Память в куче забирается целиком, встроенные элементы перемещаются по одному
+	SmallSimpleVector(SmallSimpleVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+		StealFrom(other);
+	}
+
+	// Оператор присваивания
+	SmallSimpleVector& operator=(const SmallSimpleVector& rhs) {
+		if (this != &rhs) {
+			SmallSimpleVector temp(rhs);
+			*this = std::move(temp);
+		}
+		return *this;
+	}
+
+	// Оператор перемещения
+	SmallSimpleVector& operator=(SmallSimpleVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+		if (this != &rhs) {
+			Clear();
+			if (rhs.IsInline()) {
+				// Собственной вместимости (не меньше N) заведомо хватает
+				std::uninitialized_move(rhs.begin(), rhs.end(), data_);
+				size_ = rhs.size_;
+				rhs.Clear();
+			}
+			else {
+				ArrayPtr<Type> old;
+				heap_.swap(old);
+				StealFrom(rhs);
+			}
+		}
+		return *this;
+	}
+
+	~SmallSimpleVector() {
+		std::destroy(begin(), end());
+	}
+
+	// Возвращает количество элементов в массиве
+	size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	// Возвращает вместимость массива. Не бывает меньше N
+	size_t GetCapacity() const noexcept {
+		return capacity_;
+	}
+
+	// Сообщает, пустой ли массив
+	bool IsEmpty() const noexcept {
+		return size_ == 0;
+	}
+
+	// Сообщает, хранятся ли элементы во встроенном буфере
+	bool IsInline() const noexcept {
+		return data_ == InlineData();
+	}
+
+	// Возвращает ссылку на элемент с индексом index
+	Type& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return data_[index];
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index
+	const Type& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return data_[index];
+	}
+
+	// Возвращает ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	Type& At(size_t index) {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return data_[index];
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	const Type& At(size_t index) const {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return data_[index];
+	}
+
+	// Разрушает все элементы, не изменяя вместимость массива
+	void Clear() noexcept {
+		std::destroy(begin(), end());
+		size_ = 0;
+	}
+
+	Iterator begin() noexcept {
+		return data_;
+	}
+
+	Iterator end() noexcept {
+		return data_ + size_;
+	}
+
+	ConstIterator begin() const noexcept {
+		return data_;
+	}
+
+	ConstIterator end() const noexcept {
+		return data_ + size_;
+	}
+
+	ConstIterator cbegin() const noexcept {
+		return data_;
+	}
+
+	ConstIterator cend() const noexcept {
+		return data_ + size_;
+	}
+
+	// Удаляет элемент в позиции pos, сдвигая хвост на его место
+	Iterator Erase(ConstIterator pos) {
+		assert(pos >= begin() && pos < end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		Type* it = begin() + index;
+
+		if constexpr (std::is_trivially_copyable_v<Type>) {
+			std::memmove(it, it + 1, (size_ - index - 1) * sizeof(Type));
+		}
+		else {
+			std::move(it + 1, end(), it);
+			std::destroy_at(end() - 1);
+		}
+		--size_;
+		return it;
+	}
+
+	// Вставляет значение value в позицию pos. Возвращает итератор на вставленное значение
+	Iterator Insert(ConstIterator pos, const Type& value) {
+		return Emplace(pos, value);
+	}
+
+	Iterator Insert(ConstIterator pos, Type&& value) {
+		return Emplace(pos, std::move(value));
+	}
+
+	// Удаляет последний элемент вектора. Вектор не должен быть пустым
+	void PopBack() noexcept {
+		assert(!IsEmpty());
+		--size_;
+		std::destroy_at(end());
+	}
+
+	// Добавляет элемент в конец вектора. При нехватке места увеличивает вдвое вместимость вектора
+	void PushBack(const Type& item) {
+		EmplaceBack(item);
+	}
+
+	void PushBack(Type&& item) {
+		EmplaceBack(std::move(item));
+	}
+
+	// Конструирует элемент из args после последнего элемента. Возвращает ссылку на него
+	template <typename... Args>
+	Type& EmplaceBack(Args&&... args) {
+		if (size_ == capacity_) {
+			const size_t new_capacity = NextCapacity();
+			ArrayPtr<Type> temp(new_capacity);
+			// Новый элемент конструируется до переноса старых: args могут ссылаться на элементы этого же вектора
+			ConstructAt(temp.Get() + size_, std::forward<Args>(args)...);
+			try {
+				RelocateTo(begin(), end(), temp.Get());
+			}
+			catch (...) {
+				std::destroy_at(temp.Get() + size_);
+				throw;
+			}
+			std::destroy(begin(), end());
+			heap_.swap(temp);
+			data_ = heap_.Get();
+			capacity_ = new_capacity;
+		}
+		else {
+			ConstructAt(end(), std::forward<Args>(args)...);
+		}
+		++size_;
+		return *(end() - 1);
+	}
+
+	// Конструирует элемент из args в позиции pos. Возвращает итератор на него
+	template <typename... Args>
+	Iterator Emplace(ConstIterator pos, Args&&... args) {
+		assert(pos >= begin() && pos <= end());
+		const size_t index = static_cast<size_t>(pos - cbegin());
+		if (index == size_) {
+			EmplaceBack(std::forward<Args>(args)...);
+			return begin() + index;
+		}
+
+		// args могут ссылаться на элементы этого же вектора, поэтому сначала конструируем временный объект
+		Type temp = MakeValue(std::forward<Args>(args)...);
+		if (size_ == capacity_) {
+			Reallocate(NextCapacity());
+		}
+		Type* it = begin() + index;
+		if constexpr (std::is_trivially_copyable_v<Type>) {
+			std::memmove(it + 1, it, (size_ - index) * sizeof(Type));
+			new (it) Type(std::move(temp));
+		}
+		else {
+			Type* last = end() - 1;
+			new (end()) Type(std::move(*last));
+			std::move_backward(it, last, end());
+			*it = std::move(temp);
+		}
+		++size_;
+		return it;
+	}
+
+	// Резервирует память под new_capacity элементов. До N элементов память не выделяется
+	void Reserve(size_t new_capacity) {
+		if (new_capacity > capacity_) {
+			Reallocate(new_capacity);
+		}
+	}
+
+	// Изменяет размер массива. При увеличении размера новые элементы получают значение по умолчанию для типа Type
+	void Resize(size_t new_size) {
+		if (new_size <= size_) {
+			std::destroy(begin() + new_size, end());
+			size_ = new_size;
+			return;
+		}
+		if (new_size > capacity_) {
+			Reallocate(new_size);
+		}
+		std::uninitialized_value_construct(end(), begin() + new_size);
+		size_ = new_size;
+	}
+
+	// Обменивает значение с другим вектором. Встроенные элементы обмениваются перемещением
+	void swap(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+		SmallSimpleVector temp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(temp);
+	}
+
+private:
+	alignas(Type) std::byte inline_buffer_[sizeof(Type) * N];
+	ArrayPtr<Type> heap_;
+	Type* data_ = InlineData();
+	size_t size_ = 0;
+	size_t capacity_ = N;
+
+	Type* InlineData() noexcept {
+		return reinterpret_cast<Type*>(inline_buffer_);
+	}
+
+	const Type* InlineData() const noexcept {
+		return reinterpret_cast<const Type*>(inline_buffer_);
+	}
+
+	// Конструирует объект в сырой памяти. Как и в SimpleVector, агрегаты без подходящего
+	// конструктора инициализируются списком
+	template <typename... Args>
+	static void ConstructAt(Type* dest, Args&&... args) {
+		if constexpr (std::is_constructible_v<Type, Args...>) {
+			::new (static_cast<void*>(dest)) Type(std::forward<Args>(args)...);
+		}
+		else {
+			::new (static_cast<void*>(dest)) Type{ std::forward<Args>(args)... };
+		}
+	}
+
+	template <typename... Args>
+	static Type MakeValue(Args&&... args) {
+		if constexpr (std::is_constructible_v<Type, Args...>) {
+			return Type(std::forward<Args>(args)...);
+		}
+		else {
+			return Type{ std::forward<Args>(args)... };
+		}
+	}
+
+	// Забирает содержимое other, считая себя пустым и без памяти в куче. other становится пустым и встроенным
+	void StealFrom(SmallSimpleVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+		if (other.IsInline()) {
+			std::uninitialized_move(other.begin(), other.end(), data_);
+			size_ = other.size_;
+			other.Clear();
+			return;
+		}
+		heap_.swap(other.heap_);
+		data_ = heap_.Get();
+		size_ = std::exchange(other.size_, 0);
+		capacity_ = std::exchange(other.capacity_, N);
+		other.data_ = other.InlineData();
+	}
+
+	size_t NextCapacity() const noexcept {
+		return capacity_ * 2;
+	}
+
+	// Переносит живые элементы [first, last) в сырую память dest. Копирует вместо перемещения,
+	// только если перемещение может бросить исключение, а копирование доступно
+	static void RelocateTo(Type* first, Type* last, Type* dest) {
+		if constexpr (std::is_nothrow_move_constructible_v<Type> || !std::is_copy_constructible_v<Type>) {
+			std::uninitialized_move(first, last, dest);
+		}
+		else {
+			std::uninitialized_copy(first, last, dest);
+		}
+	}
+
+	// Переносит элементы в блок кучи вместимостью new_capacity
+	void Reallocate(size_t new_capacity) {
+		ArrayPtr<Type> temp(new_capacity);
+		RelocateTo(begin(), end(), temp.Get());
+		std::destroy(begin(), end());
+		heap_.swap(temp);
+		data_ = heap_.Get();
+		capacity_ = new_capacity;
+	}
+};
+
+template <typename Type, size_t N>
+inline bool operator==(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return simd_compare::Equal(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N>
+inline bool operator!=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator<(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return simd_compare::Less(lhs.begin(), lhs.GetSize(), rhs.begin(), rhs.GetSize());
+}
+
+template <typename Type, size_t N>
+inline bool operator<=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator>(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+inline bool operator>=(const SmallSimpleVector<Type, N>& lhs, const SmallSimpleVector<Type, N>& rhs) {
+	return !(lhs < rhs);
+}
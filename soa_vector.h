@@ -0,0 +1,503 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Непрерывный участок одного столбца SoAVector: указатель и длина
+template <typename Type>
+class ColumnSpan {
+public:
+	ColumnSpan() noexcept = default;
+
+	ColumnSpan(Type* data, size_t size) noexcept
+		: data_(data)
+		, size_(size) {
+	}
+
+	Type* Data() const noexcept {
+		return data_;
+	}
+
+	size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	bool IsEmpty() const noexcept {
+		return size_ == 0;
+	}
+
+	Type& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return data_[index];
+	}
+
+	Type* begin() const noexcept {
+		return data_;
+	}
+
+	Type* end() const noexcept {
+		return data_ + size_;
+	}
+
+private:
+	Type* data_ = nullptr;
+	size_t size_ = 0;
+};
+
+// Контейнер «структура массивов» (structure of arrays): строка из полей Fields... хранится не одной структурой,
+// а по столбцу ArrayPtr на каждое поле. Проход по одному полю читает только его байты подряд и векторизуется,
+// а не тянет в кэш всю запись. Все столбцы растут вместе и всегда имеют одинаковые размер и вместимость.
+// Column<I>() даёт столбец как непрерывный ColumnSpan, а operator[] и итераторы — строку как кортеж ссылок
+// std::tuple<Fields&...>, который можно разобрать structured binding'ом.
+// Итератор — прокси: разыменование возвращает кортеж по значению, поэтому алгоритмы, переставляющие элементы
+// (std::sort, std::swap через итераторы), с ним не работают; переставлять стоит сами столбцы
+template <typename... Fields>
+class SoAVector {
+	static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+	using Columns = std::tuple<ArrayPtr<Fields>...>;
+
+	template <bool IsConst>
+	class BasicIterator;
+
+public:
+	static constexpr size_t kColumnCount = sizeof...(Fields);
+
+	template <size_t I>
+	using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+	using Value = std::tuple<Fields...>;
+	using Reference = std::tuple<Fields&...>;
+	using ConstReference = std::tuple<const Fields&...>;
+	using Iterator = BasicIterator<false>;
+	using ConstIterator = BasicIterator<true>;
+
+	SoAVector() noexcept = default;
+
+	// Создаёт size строк, поля которых инициализированы значением по умолчанию. Делегирует конструктору
+	// по умолчанию, чтобы при исключении из конструктора поля деструктор разрушил уже созданные строки
+	explicit SoAVector(size_t size)
+		: SoAVector() {
+		Resize(size);
+	}
+
+	// Конструктор копирования. Копируется столбец за столбцом
+	SoAVector(const SoAVector& other) {
+		Columns fresh = AllocateColumns(other.size_);
+		CopyColumns<false>(other.columns_, fresh, other.size_);
+		SwapColumns(fresh);
+		size_ = other.size_;
+		capacity_ = other.size_;
+	}
+
+	SoAVector(SoAVector&& other) noexcept {
+		swap(other);
+	}
+
+	SoAVector& operator=(const SoAVector& rhs) {
+		if (this != &rhs) {
+			SoAVector temp(rhs);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	SoAVector& operator=(SoAVector&& rhs) noexcept {
+		if (this != &rhs) {
+			SoAVector temp(std::move(rhs));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	~SoAVector() {
+		Clear();
+	}
+
+	size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	size_t GetCapacity() const noexcept {
+		return capacity_;
+	}
+
+	bool IsEmpty() const noexcept {
+		return size_ == 0;
+	}
+
+	// Столбец поля I целиком. Действителен до следующего изменения вместимости
+	template <size_t I>
+	ColumnSpan<FieldType<I>> Column() noexcept {
+		return ColumnSpan<FieldType<I>>(std::get<I>(columns_).Get(), size_);
+	}
+
+	template <size_t I>
+	ColumnSpan<const FieldType<I>> Column() const noexcept {
+		return ColumnSpan<const FieldType<I>>(std::get<I>(columns_).Get(), size_);
+	}
+
+	// Возвращает строку с индексом index как кортеж ссылок на её поля
+	Reference operator[](size_t index) noexcept {
+		assert(index < size_);
+		return MakeRow<Reference>(columns_, index, std::index_sequence_for<Fields...>());
+	}
+
+	ConstReference operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return MakeRow<ConstReference>(columns_, index, std::index_sequence_for<Fields...>());
+	}
+
+	// Выбрасывает исключение std::out_of_range, если index >= size
+	Reference At(size_t index) {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return (*this)[index];
+	}
+
+	ConstReference At(size_t index) const {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return (*this)[index];
+	}
+
+	Iterator begin() noexcept {
+		return Iterator(this, 0);
+	}
+
+	Iterator end() noexcept {
+		return Iterator(this, size_);
+	}
+
+	ConstIterator begin() const noexcept {
+		return ConstIterator(this, 0);
+	}
+
+	ConstIterator end() const noexcept {
+		return ConstIterator(this, size_);
+	}
+
+	ConstIterator cbegin() const noexcept {
+		return begin();
+	}
+
+	ConstIterator cend() const noexcept {
+		return end();
+	}
+
+	// Разрушает все строки, не освобождая память
+	void Clear() noexcept {
+		ForEachColumn([this](auto index) {
+			std::destroy_n(std::get<decltype(index)::value>(columns_).Get(), size_);
+		});
+		size_ = 0;
+	}
+
+	// Добавляет строку из кортежа значений полей
+	void PushBack(const Value& row) {
+		std::apply([this](const Fields&... fields) {
+			EmplaceBack(fields...);
+		}, row);
+	}
+
+	void PushBack(Value&& row) {
+		std::apply([this](Fields&... fields) {
+			EmplaceBack(std::move(fields)...);
+		}, row);
+	}
+
+	// Добавляет строку, конструируя каждое поле из своего аргумента. Возвращает ссылки на поля новой строки.
+	// Если конструктор поля бросает исключение, уже построенные поля строки разрушаются, и контейнер не меняется
+	template <typename... Args>
+	Reference EmplaceBack(Args&&... args) {
+		static_assert(sizeof...(Args) == kColumnCount, "EmplaceBack takes one argument per field");
+		if (size_ == capacity_) {
+			// args могут ссылаться на поля этого же контейнера, а рост переносит столбцы
+			Value row(std::forward<Args>(args)...);
+			Reallocate(DoublingGrowth::Grow(capacity_, kRowSize));
+			std::apply([this](Fields&... fields) {
+				ConstructRow(size_, std::index_sequence_for<Fields...>(), std::move(fields)...);
+			}, row);
+		}
+		else {
+			ConstructRow(size_, std::index_sequence_for<Fields...>(), std::forward<Args>(args)...);
+		}
+		++size_;
+		return (*this)[size_ - 1];
+	}
+
+	// Удаляет последнюю строку. Контейнер не должен быть пустым
+	void PopBack() noexcept {
+		assert(!IsEmpty());
+		--size_;
+		ForEachColumn([this](auto index) {
+			std::destroy_at(std::get<decltype(index)::value>(columns_).Get() + size_);
+		});
+	}
+
+	// Резервирует память под new_capacity строк во всех столбцах
+	void Reserve(size_t new_capacity) {
+		if (new_capacity > capacity_) {
+			Reallocate(new_capacity);
+		}
+	}
+
+	// Изменяет число строк. Новые строки получают значения полей по умолчанию
+	void Resize(size_t new_size) {
+		while (size_ > new_size) {
+			PopBack();
+		}
+		Reserve(new_size);
+		while (size_ < new_size) {
+			ConstructRow(size_, std::index_sequence_for<Fields...>(), Fields()...);
+			++size_;
+		}
+	}
+
+	void swap(SoAVector& other) noexcept {
+		SwapColumns(other.columns_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+private:
+	static constexpr size_t kRowSize = (sizeof(Fields) + ...);
+
+	// Столбец переносится без риска исключения: побайтно или noexcept-перемещением
+	template <typename Field>
+	static constexpr bool kNothrowRelocate = is_trivially_relocatable_v<Field> || std::is_nothrow_move_constructible_v<Field>;
+
+	Columns columns_;
+	size_t size_ = 0;
+	size_t capacity_ = 0;
+
+	// Вызывает f(std::integral_constant<size_t, I>()) для каждого столбца I по порядку
+	template <typename Function>
+	static void ForEachColumn(Function&& f) {
+		ForEachColumnImpl(f, std::index_sequence_for<Fields...>());
+	}
+
+	template <typename Function, size_t... I>
+	static void ForEachColumnImpl(Function& f, std::index_sequence<I...>) {
+		(f(std::integral_constant<size_t, I>()), ...);
+	}
+
+	template <typename Row, typename ColumnsRef, size_t... I>
+	static Row MakeRow(ColumnsRef& columns, size_t index, std::index_sequence<I...>) noexcept {
+		return Row(std::get<I>(columns)[index]...);
+	}
+
+	static Columns AllocateColumns(size_t capacity) {
+		return Columns(ArrayPtr<Fields>(capacity)...);
+	}
+
+	void SwapColumns(Columns& other) noexcept {
+		ForEachColumn([&](auto index) {
+			std::get<decltype(index)::value>(columns_).swap(std::get<decltype(index)::value>(other));
+		});
+	}
+
+	// Конструирует поля строки index в свободных слотах столбцов. При исключении построенные поля разрушаются
+	template <size_t... I, typename... Args>
+	void ConstructRow(size_t index, std::index_sequence<I...>, Args&&... args) {
+		size_t constructed = 0;
+		try {
+			((new (std::get<I>(columns_).Get() + index) Fields(std::forward<Args>(args)), ++constructed), ...);
+		}
+		catch (...) {
+			((I < constructed ? std::destroy_at(std::get<I>(columns_).Get() + index) : void()), ...);
+			throw;
+		}
+	}
+
+	// Копирует первые count строк столбцов source в dest. Если OnlyThrowingMoves, копируются только столбцы,
+	// перемещение которых может бросить исключение. При исключении скопированное разрушается
+	template <bool OnlyThrowingMoves>
+	static void CopyColumns(const Columns& source, Columns& dest, size_t count) {
+		bool copied[kColumnCount] = {};
+		try {
+			ForEachColumn([&](auto index) {
+				constexpr size_t I = decltype(index)::value;
+				if constexpr (!OnlyThrowingMoves || !kNothrowRelocate<FieldType<I>>) {
+					std::uninitialized_copy_n(std::get<I>(source).Get(), count, std::get<I>(dest).Get());
+					copied[I] = true;
+				}
+			});
+		}
+		catch (...) {
+			ForEachColumn([&](auto index) {
+				constexpr size_t I = decltype(index)::value;
+				if (copied[I]) {
+					std::destroy_n(std::get<I>(dest).Get(), count);
+				}
+			});
+			throw;
+		}
+	}
+
+	// Переносит все столбцы в новые блоки под new_capacity строк. Сначала выделяются все блоки и копируются
+	// столбцы, перенос которых может бросить, и только затем без исключений переносятся остальные:
+	// если что-то не удалось, исходные столбцы не тронуты
+	void Reallocate(size_t new_capacity) {
+		Columns fresh = AllocateColumns(new_capacity);
+		CopyColumns<true>(columns_, fresh, size_);
+		ForEachColumn([&](auto index) {
+			constexpr size_t I = decltype(index)::value;
+			using Field = FieldType<I>;
+			Field* from = std::get<I>(columns_).Get();
+			Field* to = std::get<I>(fresh).Get();
+			if constexpr (is_trivially_relocatable_v<Field>) {
+				if (size_ != 0) {
+					std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), size_ * sizeof(Field));
+				}
+			}
+			else {
+				// Столбцы с бросающим перемещением уже скопированы в CopyColumns
+				if constexpr (std::is_nothrow_move_constructible_v<Field>) {
+					std::uninitialized_move_n(from, size_, to);
+				}
+				std::destroy_n(from, size_);
+			}
+		});
+		SwapColumns(fresh);
+		capacity_ = new_capacity;
+	}
+
+	// Итератор произвольного доступа по строкам. Разыменование даёт кортеж ссылок на поля строки
+	template <bool IsConst>
+	class BasicIterator {
+		using Container = std::conditional_t<IsConst, const SoAVector, SoAVector>;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = Value;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = std::conditional_t<IsConst, ConstReference, Reference>;
+
+		BasicIterator() noexcept = default;
+
+		// Неконстантный итератор приводится к константному
+		template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+		BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+			: container_(other.container_)
+			, index_(other.index_) {
+		}
+
+		reference operator*() const noexcept {
+			return (*container_)[index_];
+		}
+
+		reference operator[](difference_type offset) const noexcept {
+			return (*container_)[index_ + offset];
+		}
+
+		BasicIterator& operator++() noexcept {
+			++index_;
+			return *this;
+		}
+
+		BasicIterator operator++(int) noexcept {
+			BasicIterator copy = *this;
+			++index_;
+			return copy;
+		}
+
+		BasicIterator& operator--() noexcept {
+			--index_;
+			return *this;
+		}
+
+		BasicIterator operator--(int) noexcept {
+			BasicIterator copy = *this;
+			--index_;
+			return copy;
+		}
+
+		BasicIterator& operator+=(difference_type offset) noexcept {
+			index_ += offset;
+			return *this;
+		}
+
+		BasicIterator& operator-=(difference_type offset) noexcept {
+			index_ -= offset;
+			return *this;
+		}
+
+		friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+			return it += offset;
+		}
+
+		friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+			return it += offset;
+		}
+
+		friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+			return it -= offset;
+		}
+
+		friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+		}
+
+		friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ == rhs.index_;
+		}
+
+		friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ != rhs.index_;
+		}
+
+		friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ < rhs.index_;
+		}
+
+		friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return !(lhs < rhs);
+		}
+
+	private:
+		friend class SoAVector;
+		template <bool>
+		friend class BasicIterator;
+
+		BasicIterator(Container* container, size_t index) noexcept
+			: container_(container)
+			, index_(index) {
+		}
+
+		Container* container_ = nullptr;
+		size_t index_ = 0;
+	};
+};
+
+template <typename... Fields>
+inline bool operator==(const SoAVector<Fields...>& lhs, const SoAVector<Fields...>& rhs) {
+	return lhs.GetSize() == rhs.GetSize() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename... Fields>
+inline bool operator!=(const SoAVector<Fields...>& lhs, const SoAVector<Fields...>& rhs) {
+	return !(lhs == rhs);
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include "array_ptr.h"
+#include "segment_layout.h"
+#include "simple_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор с интерфейсом SimpleVector для добавления в конец, чьи элементы никогда не переезжают.
+// Память выделяется сегментами геометрически растущего размера (см. SegmentLayout): при росте добавляется
+// новый сегмент, а старые остаются на месте. Поэтому рост не копирует элементы, а указатели, ссылки
+// и итераторы на элементы остаются действительными, пока сам элемент не удалён. Итераторы, в отличие
+// от ссылок, привязаны к объекту вектора и после его перемещения или swap не используются.
+// operator[] вычисляет сегмент по старшему биту индекса за O(1)
+template <typename Type, size_t FirstSegmentLog = 4>
+class StableSimpleVector {
+	using Layout = SegmentLayout<FirstSegmentLog>;
+
+	template <bool IsConst>
+	class BasicIterator;
+
+public:
+	using Iterator = BasicIterator<false>;
+	using ConstIterator = BasicIterator<true>;
+
+	StableSimpleVector() noexcept = default;
+
+	// Конструкторы, создающие элементы, делегируют конструктору по умолчанию: если конструктор элемента
+	// бросит исключение, деструктор вектора разрушит уже созданные элементы
+
+	// Создаёт вектор из size элементов, инициализированных значением по умолчанию
+	explicit StableSimpleVector(size_t size)
+		: StableSimpleVector() {
+		Resize(size);
+	}
+
+	// Конструктор сразу резервирует память. Элементы не конструируются
+	StableSimpleVector(ReserveProxyObj other) {
+		Reserve(other.GetSize());
+	}
+
+	// Создаёт вектор из size элементов, инициализированных значением value
+	StableSimpleVector(size_t size, const Type& value)
+		: StableSimpleVector() {
+		Reserve(size);
+		for (size_t i = 0; i < size; ++i) {
+			EmplaceBack(value);
+		}
+	}
+
+	// Создаёт вектор из std::initializer_list
+	StableSimpleVector(std::initializer_list<Type> init)
+		: StableSimpleVector() {
+		Reserve(init.size());
+		for (const Type& item : init) {
+			EmplaceBack(item);
+		}
+	}
+
+	// Конструктор копирования
+	StableSimpleVector(const StableSimpleVector& other)
+		: StableSimpleVector() {
+		Reserve(other.size_);
+		for (const Type& item : other) {
+			EmplaceBack(item);
+		}
+	}
+
+	// Конструктор перемещения. Сегменты забираются целиком
+	StableSimpleVector(StableSimpleVector&& other) noexcept {
+		swap(other);
+	}
+
+	// Оператор присваивания
+	StableSimpleVector& operator=(const StableSimpleVector& rhs) {
+		if (this != &rhs) {
+			StableSimpleVector temp(rhs);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	// Оператор перемещения
+	StableSimpleVector& operator=(StableSimpleVector&& rhs) noexcept {
+		if (this != &rhs) {
+			StableSimpleVector temp(std::move(rhs));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	~StableSimpleVector() {
+		Clear();
+	}
+
+	// Возвращает количество элементов в массиве
+	size_t GetSize() const noexcept {
+		return size_;
+	}
+
+	// Возвращает вместимость выделенных сегментов
+	size_t GetCapacity() const noexcept {
+		return Layout::SegmentStart(segment_count_);
+	}
+
+	// Сообщает, пустой ли массив
+	bool IsEmpty() const noexcept {
+		return size_ == 0;
+	}
+
+	// Возвращает ссылку на элемент с индексом index
+	Type& operator[](size_t index) noexcept {
+		assert(index < size_);
+		return *Locate(index);
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index
+	const Type& operator[](size_t index) const noexcept {
+		assert(index < size_);
+		return *Locate(index);
+	}
+
+	// Возвращает ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	Type& At(size_t index) {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return *Locate(index);
+	}
+
+	// Возвращает константную ссылку на элемент с индексом index. Выбрасывает исключение std::out_of_range, если index >= size
+	const Type& At(size_t index) const {
+		if (index >= size_) {
+			throw std::out_of_range("Error: out of range");
+		}
+		return *Locate(index);
+	}
+
+	// Разрушает все элементы, не освобождая сегменты
+	void Clear() noexcept {
+		while (size_ > 0) {
+			PopBack();
+		}
+	}
+
+	Iterator begin() noexcept {
+		return Iterator(segments_, 0);
+	}
+
+	Iterator end() noexcept {
+		return Iterator(segments_, size_);
+	}
+
+	ConstIterator begin() const noexcept {
+		return ConstIterator(segments_, 0);
+	}
+
+	ConstIterator end() const noexcept {
+		return ConstIterator(segments_, size_);
+	}
+
+	ConstIterator cbegin() const noexcept {
+		return begin();
+	}
+
+	ConstIterator cend() const noexcept {
+		return end();
+	}
+
+	// Удаляет последний элемент вектора. Вектор не должен быть пустым
+	void PopBack() noexcept {
+		assert(!IsEmpty());
+		--size_;
+		std::destroy_at(Locate(size_));
+	}
+
+	// Добавляет элемент в конец вектора. При нехватке места выделяет следующий сегмент, не трогая имеющиеся
+	void PushBack(const Type& item) {
+		EmplaceBack(item);
+	}
+
+	void PushBack(Type&& item) {
+		EmplaceBack(std::move(item));
+	}
+
+	// Конструирует элемент из args после последнего элемента. Возвращает ссылку на него.
+	// Элементы не переезжают, поэтому args могут ссылаться на элементы этого же вектора
+	template <typename... Args>
+	Type& EmplaceBack(Args&&... args) {
+		if (size_ == GetCapacity()) {
+			AddSegment();
+		}
+		Type* slot = Locate(size_);
+		if constexpr (std::is_constructible_v<Type, Args&&...>) {
+			new (slot) Type(std::forward<Args>(args)...);
+		}
+		else {
+			new (slot) Type{ std::forward<Args>(args)... };
+		}
+		++size_;
+		return *slot;
+	}
+
+	// Выделяет сегменты под new_capacity элементов
+	void Reserve(size_t new_capacity) {
+		while (GetCapacity() < new_capacity) {
+			AddSegment();
+		}
+	}
+
+	// Изменяет размер массива. При увеличении размера новые элементы получают значение по умолчанию для типа Type
+	void Resize(size_t new_size) {
+		while (size_ > new_size) {
+			PopBack();
+		}
+		Reserve(new_size);
+		while (size_ < new_size) {
+			new (Locate(size_)) Type();
+			++size_;
+		}
+	}
+
+	// Обменивает значение с другим вектором за O(число сегментов)
+	void swap(StableSimpleVector& other) noexcept {
+		for (size_t segment = 0; segment < Layout::kMaxSegments; ++segment) {
+			segments_[segment].swap(other.segments_[segment]);
+		}
+		std::swap(segment_count_, other.segment_count_);
+		std::swap(size_, other.size_);
+	}
+
+private:
+	ArrayPtr<Type> segments_[Layout::kMaxSegments];
+	size_t segment_count_ = 0;
+	size_t size_ = 0;
+
+	static Type* Locate(const ArrayPtr<Type>* segments, size_t index) noexcept {
+		const size_t segment = Layout::SegmentOf(index);
+		return segments[segment].Get() + Layout::OffsetInSegment(index, segment);
+	}
+
+	Type* Locate(size_t index) const noexcept {
+		return Locate(segments_, index);
+	}
+
+	void AddSegment() {
+		if (segment_count_ == Layout::kMaxSegments) {
+			throw std::length_error("StableSimpleVector is too long");
+		}
+		ArrayPtr<Type> segment(Layout::SegmentSize(segment_count_));
+		segments_[segment_count_].swap(segment);
+		++segment_count_;
+	}
+
+	// Итератор произвольного доступа: хранит индекс и находит элемент через раскладку сегментов
+	template <bool IsConst>
+	class BasicIterator {
+		using Segments = const ArrayPtr<Type>*;
+
+	public:
+		using iterator_category = std::random_access_iterator_tag;
+		using value_type = Type;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<IsConst, const Type*, Type*>;
+		using reference = std::conditional_t<IsConst, const Type&, Type&>;
+
+		BasicIterator() noexcept = default;
+
+		// Неконстантный итератор приводится к константному
+		template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+		BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+			: segments_(other.segments_)
+			, index_(other.index_) {
+		}
+
+		reference operator*() const noexcept {
+			return *StableSimpleVector::Locate(segments_, index_);
+		}
+
+		pointer operator->() const noexcept {
+			return StableSimpleVector::Locate(segments_, index_);
+		}
+
+		reference operator[](difference_type offset) const noexcept {
+			return *(*this + offset);
+		}
+
+		BasicIterator& operator++() noexcept {
+			++index_;
+			return *this;
+		}
+
+		BasicIterator operator++(int) noexcept {
+			BasicIterator copy = *this;
+			++index_;
+			return copy;
+		}
+
+		BasicIterator& operator--() noexcept {
+			--index_;
+			return *this;
+		}
+
+		BasicIterator operator--(int) noexcept {
+			BasicIterator copy = *this;
+			--index_;
+			return copy;
+		}
+
+		BasicIterator& operator+=(difference_type offset) noexcept {
+			index_ = static_cast<size_t>(static_cast<difference_type>(index_) + offset);
+			return *this;
+		}
+
+		BasicIterator& operator-=(difference_type offset) noexcept {
+			return *this += -offset;
+		}
+
+		friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+			return it += offset;
+		}
+
+		friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+			return it += offset;
+		}
+
+		friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+			return it -= offset;
+		}
+
+		friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+		}
+
+		friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ == rhs.index_;
+		}
+
+		friend bool operator!=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ != rhs.index_;
+		}
+
+		friend bool operator<(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return lhs.index_ < rhs.index_;
+		}
+
+		friend bool operator>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return rhs < lhs;
+		}
+
+		friend bool operator<=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return !(rhs < lhs);
+		}
+
+		friend bool operator>=(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+			return !(lhs < rhs);
+		}
+
+	private:
+		friend class StableSimpleVector;
+		friend class BasicIterator<!IsConst>;
+
+		BasicIterator(Segments segments, size_t index) noexcept
+			: segments_(segments)
+			, index_(index) {
+		}
+
+		Segments segments_ = nullptr;
+		size_t index_ = 0;
+	};
+};
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator==(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator!=(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator<(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator<=(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator>(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename Type, size_t FirstSegmentLog>
+inline bool operator>=(const StableSimpleVector<Type, FirstSegmentLog>& lhs, const StableSimpleVector<Type, FirstSegmentLog>& rhs) {
+	return !(lhs < rhs);
+}
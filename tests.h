@@ -1,9 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory_resource>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 inline void Test1() {
 	// Инициализация конструктором по умолчанию
@@ -443,3 +459,1624 @@ void TestNoncopiableResize() {
 	cout << "Done!" << endl << endl;
 }
 
+
+// Считает, сколько объектов было сконструировано и сколько ещё живо
+struct CountedObj {
+	static inline size_t constructed = 0;
+	static inline size_t alive = 0;
+
+	CountedObj() {
+		++constructed;
+		++alive;
+	}
+	CountedObj(const CountedObj&) {
+		++constructed;
+		++alive;
+	}
+	CountedObj(CountedObj&&) noexcept {
+		++constructed;
+		++alive;
+	}
+	CountedObj& operator=(const CountedObj&) = default;
+	CountedObj& operator=(CountedObj&&) = default;
+	~CountedObj() {
+		--alive;
+	}
+
+	static void Reset() {
+		constructed = 0;
+		alive = 0;
+	}
+};
+
+void TestReserveDoesNotConstruct() {
+	cout << "Test reserve does not construct elements" << endl;
+	CountedObj::Reset();
+	{
+		SimpleVector<CountedObj> v(Reserve(10000000));
+		assert(v.GetCapacity() == 10000000);
+		assert(CountedObj::constructed == 0);
+
+		v.Reserve(20000000);
+		assert(CountedObj::constructed == 0);
+
+		v.Resize(3);
+		assert(CountedObj::constructed == 3);
+		v.PopBack();
+		assert(CountedObj::alive == 2);
+		v.Clear();
+		assert(CountedObj::alive == 0);
+
+		for (int i = 0; i < 5; ++i) {
+			v.PushBack(CountedObj());
+		}
+		assert(CountedObj::alive == 5);
+	}
+	assert(CountedObj::alive == 0);
+	cout << "Done!" << endl << endl;
+}
+
+void TestInsertEraseInPlace() {
+	cout << "Test in-place insert and erase" << endl;
+	{
+		SimpleVector<int> v(Reserve(8));
+		for (int i = 0; i < 4; ++i) {
+			v.PushBack(i);
+		}
+		const auto old_begin = v.begin();
+		v.Insert(v.begin() + 1, 42);
+		v.Insert(v.begin(), v[4]);
+		assert((v == SimpleVector<int>{3, 0, 42, 1, 2, 3}));
+		v.Erase(v.begin() + 2);
+		assert((v == SimpleVector<int>{3, 0, 1, 2, 3}));
+		assert(v.begin() == old_begin);
+		assert(v.GetCapacity() == 8);
+	}
+	{
+		SimpleVector<std::string> v(Reserve(8));
+		v.PushBack("a"s);
+		v.PushBack("b"s);
+		v.PushBack("c"s);
+		const auto old_begin = v.begin();
+		auto it = v.Insert(v.begin() + 1, "x"s);
+		assert(*it == "x"s);
+		v.Insert(v.begin(), v[3]);
+		assert((v == SimpleVector<std::string>{"c"s, "a"s, "x"s, "b"s, "c"s}));
+		it = v.Erase(v.begin() + 1);
+		assert(*it == "x"s);
+		v.Erase(v.end() - 1);
+		assert((v == SimpleVector<std::string>{"c"s, "x"s, "b"s}));
+		assert(v.begin() == old_begin);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestPmrAllocator() {
+	cout << "Test pmr allocator" << endl;
+	{
+		std::byte buffer[1024];
+		std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+		::pmr::SimpleVector<int> v(&arena);
+		for (int i = 0; i < 20; ++i) {
+			v.PushBack(i);
+		}
+		const auto* first = reinterpret_cast<const std::byte*>(v.begin());
+		assert(first >= buffer && first < buffer + sizeof(buffer));
+		assert(v.GetAllocator().resource() == &arena);
+
+		// Копия не наследует ресурс (select_on_container_copy_construction)
+		::pmr::SimpleVector<int> copy(v);
+		assert(copy.GetAllocator().resource() == std::pmr::get_default_resource());
+		assert(copy == v);
+
+		// Присваивание перемещением между разными ресурсами перемещает элементы, а не память
+		::pmr::SimpleVector<int> other;
+		other = std::move(v);
+		assert(other.GetAllocator().resource() == std::pmr::get_default_resource());
+		assert(other == copy);
+	}
+	{
+		std::pmr::monotonic_buffer_resource arena;
+		::pmr::SimpleVector<std::pmr::string> v(&arena);
+		v.PushBack(std::pmr::string("a rather long string that does not fit into SSO"));
+		v.Insert(v.begin(), std::pmr::string("another long string that does not fit into SSO"));
+		assert(v[0].get_allocator().resource() == &arena);
+		assert(v[1].get_allocator().resource() == &arena);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestSmallVector() {
+	cout << "Test small vector" << endl;
+	using SmallVec = SmallSimpleVector<int, 4>;
+	// Инициализация конструктором по умолчанию не выделяет память
+	{
+		SmallVec v;
+		assert(v.IsEmpty());
+		assert(v.GetCapacity() == 4);
+		assert(v.IsInline());
+	}
+	// Инициализация размером, значением и initializer_list
+	{
+		SmallVec v(3);
+		assert(v.GetSize() == 3 && v.IsInline());
+		assert(v[2] == 0);
+
+		SmallVec big(10, 42);
+		assert(big.GetSize() == 10 && !big.IsInline());
+		assert(big[9] == 42);
+
+		SmallVec list{ 1, 2, 3 };
+		assert(list.GetSize() == 3);
+		assert(&list.At(2) == &list[2]);
+		try {
+			list.At(3);
+			assert(false);
+		}
+		catch (const std::out_of_range&) {
+		}
+	}
+	// PushBack остаётся во встроенном буфере до N элементов
+	{
+		SmallVec v;
+		for (int i = 0; i < 4; ++i) {
+			v.PushBack(i);
+		}
+		assert(v.IsInline());
+		v.PushBack(v[0]);
+		assert(!v.IsInline());
+		assert(v.GetCapacity() == 8);
+		assert((v == SmallVec{ 0, 1, 2, 3, 0 }));
+		v.PopBack();
+		assert((v == SmallVec{ 0, 1, 2, 3 }));
+	}
+	// Вставка и удаление
+	{
+		SmallVec v{ 1, 2, 3, 4 };
+		auto it = v.Insert(v.begin() + 2, 42);
+		assert(*it == 42);
+		assert((v == SmallVec{ 1, 2, 42, 3, 4 }));
+		v.Erase(v.begin() + 3);
+		assert((v == SmallVec{ 1, 2, 42, 4 }));
+		v.Insert(v.begin(), -3);
+		v.Insert(v.end(), 99);
+		assert((v == SmallVec{ -3, 1, 2, 42, 4, 99 }));
+
+		SmallVec empty_vector;
+		empty_vector.Insert(empty_vector.begin(), 7);
+		assert(empty_vector == SmallVec{ 7 });
+	}
+	// Изменение размера
+	{
+		SmallVec v(3);
+		v[2] = 17;
+		v.Resize(7);
+		assert(v.GetSize() == 7);
+		assert(v[2] == 17 && v[3] == 0);
+		v.Resize(2);
+		assert(v.GetSize() == 2);
+		assert(v.GetCapacity() == 7);
+	}
+	// Копирование, перемещение и обмен
+	{
+		SmallVec inline_vec{ 1, 2 };
+		SmallVec heap_vec{ 1, 2, 3, 4, 5 };
+		SmallVec copy(heap_vec);
+		assert(copy == heap_vec && &copy[0] != &heap_vec[0]);
+
+		const int* heap_data = &heap_vec[0];
+		SmallVec moved(std::move(heap_vec));
+		assert(&moved[0] == heap_data);
+		assert(heap_vec.IsEmpty() && heap_vec.IsInline());
+
+		inline_vec.swap(moved);
+		assert((inline_vec == SmallVec{ 1, 2, 3, 4, 5 }));
+		assert((moved == SmallVec{ 1, 2 }));
+
+		moved = inline_vec;
+		assert(moved == inline_vec);
+	}
+	// Сравнение
+	{
+		assert((SmallVec{ 1, 2, 3 } != SmallVec{ 1, 2, 2 }));
+		assert((SmallVec{ 1, 2, 3 } < SmallVec{ 1, 2, 3, 1 }));
+		assert((SmallVec{ 1, 2, 3 } > SmallVec{ 1, 2, 2, 1 }));
+		assert((SmallVec{ 1, 2, 3 } >= SmallVec{ 1, 2, 3 }));
+		assert((SmallVec{ 1, 2, 3 } <= SmallVec{ 1, 2, 4 }));
+	}
+	// Некопируемые объекты
+	{
+		SmallSimpleVector<X, 2> v;
+		for (size_t i = 0; i < 5; ++i) {
+			v.PushBack(X(i));
+		}
+		v.Insert(v.begin(), X(6));
+		assert(v.begin()->GetX() == 6);
+		v.EmplaceBack(7u);
+		v.Emplace(v.end() - 1, 8u);
+		assert(v[6].GetX() == 8 && v[7].GetX() == 7);
+		v.PopBack();
+		v.PopBack();
+		auto it = v.Erase(v.begin());
+		assert(it->GetX() == 0);
+		SmallSimpleVector<X, 2> moved = std::move(v);
+		assert(moved.GetSize() == 5);
+		assert(moved[4].GetX() == 4);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+// Дескриптор, помеченный как тривиально перемещаемый: при переносе побайтно конструктор перемещения не вызывается
+struct RelocatableHandle {
+	static inline size_t moves = 0;
+
+	explicit RelocatableHandle(int value)
+		: value_(std::make_unique<int>(value)) {
+	}
+	RelocatableHandle(RelocatableHandle&& other) noexcept
+		: value_(std::move(other.value_)) {
+		++moves;
+	}
+	RelocatableHandle& operator=(RelocatableHandle&& other) noexcept {
+		value_ = std::move(other.value_);
+		++moves;
+		return *this;
+	}
+	int Get() const {
+		return *value_;
+	}
+
+private:
+	std::unique_ptr<int> value_;
+};
+
+template <>
+struct is_trivially_relocatable<RelocatableHandle> : std::true_type {
+};
+
+void TestTriviallyRelocatableGrowth() {
+	cout << "Test trivially relocatable growth" << endl;
+	{
+		SimpleVector<int, MallocAllocator<int>> v;
+		for (int i = 0; i < 1000; ++i) {
+			v.PushBack(i);
+		}
+		v.Insert(v.begin(), v[999]);
+		v.Erase(v.begin() + 1);
+		assert(v.GetSize() == 1000);
+		assert(v[0] == 999 && v[1] == 1 && v[999] == 999);
+	}
+	{
+		SimpleVector<std::unique_ptr<int>, MallocAllocator<std::unique_ptr<int>>> v;
+		for (int i = 0; i < 100; ++i) {
+			v.PushBack(std::make_unique<int>(i));
+		}
+		v.Insert(v.begin() + 50, std::make_unique<int>(-1));
+		v.Erase(v.begin());
+		assert(v.GetSize() == 100);
+		assert(*v[0] == 1 && *v[49] == -1 && *v[99] == 99);
+		v.Resize(200);
+		assert(v[150] == nullptr && *v[99] == 99);
+	}
+	{
+		RelocatableHandle::moves = 0;
+		SimpleVector<RelocatableHandle> v;
+		for (int i = 0; i < 64; ++i) {
+			v.PushBack(RelocatableHandle(i));
+		}
+		// По одному перемещению из аргумента PushBack и по одному лишнему на каждый из 7 ростов вместимости.
+		// Поэлементный перенос при росте дал бы ещё 1 + 2 + ... + 32 = 63 перемещения
+		assert(RelocatableHandle::moves == 64 + 7);
+		for (int i = 0; i < 64; ++i) {
+			assert(v[i].Get() == i);
+		}
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestGrowthPolicies() {
+	cout << "Test growth policies" << endl;
+	{
+		SimpleVector<int, std::allocator<int>, OneAndHalfGrowth> v;
+		for (int i = 0; i < 5; ++i) {
+			v.PushBack(i);
+		}
+		// 0 -> 1 -> 2 -> 3 -> 4 -> 6
+		assert(v.GetCapacity() == 6);
+	}
+	{
+		SimpleVector<char, std::allocator<char>, SizeClassGrowth> v;
+		v.PushBack('a');
+		assert(v.GetCapacity() == 16);
+		for (int i = 0; i < 16; ++i) {
+			v.PushBack('b');
+		}
+		assert(v.GetCapacity() == 32);
+		assert(SizeClassGrowth::RoundToSizeClass(100) == 112);
+		assert(SizeClassGrowth::RoundToSizeClass(1025) == 1280);
+	}
+	{
+		SimpleVector<int, std::allocator<int>, PageRoundedGrowth<4096>> v(Reserve(1000));
+		for (int i = 0; i < 1001; ++i) {
+			v.PushBack(i);
+		}
+		// 2000 * 4 байт = 7,8 КБ округляются до двух страниц
+		assert(v.GetCapacity() == 2048);
+	}
+	// ShrinkToFit
+	{
+		SimpleVector<int> v(Reserve(100));
+		v.PushBack(1);
+		v.PushBack(2);
+		v.ShrinkToFit();
+		assert(v.GetCapacity() == 2);
+		assert((v == SimpleVector<int>{1, 2}));
+		v.Clear();
+		v.ShrinkToFit();
+		assert(v.GetCapacity() == 0);
+		assert(v.begin() == nullptr);
+	}
+	// Автоматическое ужатие с гистерезисом
+	{
+		SimpleVector<std::string, std::allocator<std::string>, HysteresisShrink<>> v;
+		for (int i = 0; i < 64; ++i) {
+			v.PushBack(std::to_string(i));
+		}
+		assert(v.GetCapacity() == 64);
+		// Чередование на границе не вызывает перевыделений
+		v.PopBack();
+		v.PushBack("63"s);
+		assert(v.GetCapacity() == 64);
+		while (v.GetSize() > 16) {
+			v.PopBack();
+		}
+		assert(v.GetCapacity() == 32);
+		assert(v[15] == "15"s);
+		v.Clear();
+		assert(v.GetCapacity() == 16);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+struct Record {
+	int id;
+	std::string name;
+	double weight;
+};
+
+void TestEmplace() {
+	cout << "Test emplace" << endl;
+	{
+		SimpleVector<Record> v;
+		Record& first = v.EmplaceBack(1, "first"s, 1.5);
+		assert(first.id == 1 && first.name == "first"s);
+		v.EmplaceBack(3, "third"s, 3.5);
+		auto it = v.Emplace(v.begin() + 1, 2, "second"s, 2.5);
+		assert(it == v.begin() + 1);
+		assert(v[1].id == 2 && v[2].name == "third"s);
+	}
+	// SmallSimpleVector конструирует агрегаты так же, как SimpleVector
+	{
+		SmallSimpleVector<Record, 2> v;
+		v.EmplaceBack(1, "first"s, 1.5);
+		v.EmplaceBack(3, "third"s, 3.5);
+		v.Emplace(v.begin() + 1, 2, "second"s, 2.5);
+		v.EmplaceBack(4, "heap"s, 4.5);
+		assert(!v.IsInline() && v[1].id == 2 && v[3].name == "heap"s);
+	}
+	{
+		// Конструктор вызывается ровно один раз на элемент, без временных копий и перемещений
+		CountedObj::Reset();
+		SimpleVector<CountedObj> v(Reserve(4));
+		v.EmplaceBack();
+		v.EmplaceBack();
+		v.Emplace(v.end());
+		assert(CountedObj::constructed == 3);
+	}
+	{
+		SimpleVector<std::string> v;
+		v.EmplaceBack(3, 'a');
+		v.EmplaceBack(v[0]);
+		v.Emplace(v.begin(), v[1], 1);
+		assert((v == SimpleVector<std::string>{"aa"s, "aaa"s, "aaa"s}));
+	}
+	{
+		SimpleVector<X> v;
+		v.EmplaceBack(1u);
+		v.Emplace(v.begin(), 0u);
+		assert(v[0].GetX() == 0 && v[1].GetX() == 1);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestRangeOperations() {
+	cout << "Test range operations" << endl;
+	// Append
+	{
+		SimpleVector<int> v{ 1, 2 };
+		const int arr[] = { 3, 4, 5 };
+		v.Append(std::begin(arr), std::end(arr));
+		v.Append({ 6, 7 });
+		v.Append(2, 8);
+		assert((v == SimpleVector<int>{1, 2, 3, 4, 5, 6, 7, 8, 8}));
+	}
+	// Вставка диапазона: одно перевыделение на всю вставку
+	{
+		SimpleVector<std::string> v{ "a"s, "e"s };
+		const std::string letters[] = { "b"s, "c"s, "d"s };
+		auto it = v.Insert(v.begin() + 1, std::begin(letters), std::end(letters));
+		assert(*it == "b"s);
+		assert(v.GetCapacity() == 5);
+		assert((v == SimpleVector<std::string>{"a"s, "b"s, "c"s, "d"s, "e"s}));
+
+		// Вставка в пределах вместимости не перевыделяет память
+		v.Reserve(20);
+		const auto old_begin = v.begin();
+		v.Insert(v.begin() + 2, { "x"s, "y"s });
+		v.Insert(v.begin(), 2, v[6]);
+		assert(v.begin() == old_begin);
+		assert((v == SimpleVector<std::string>{"e"s, "e"s, "a"s, "b"s, "x"s, "y"s, "c"s, "d"s, "e"s}));
+	}
+	// Вставка из однопроходного диапазона
+	{
+		SimpleVector<int> v{ 1, 5 };
+		std::istringstream input("2 3 4");
+		v.Insert(v.begin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+		assert((v == SimpleVector<int>{1, 2, 3, 4, 5}));
+	}
+	// Удаление диапазона
+	{
+		SimpleVector<int> v{ 1, 2, 3, 4, 5, 6 };
+		auto it = v.Erase(v.begin() + 1, v.begin() + 4);
+		assert(*it == 5);
+		assert((v == SimpleVector<int>{1, 5, 6}));
+		v.Erase(v.begin(), v.end());
+		assert(v.IsEmpty());
+
+		SimpleVector<X> noncopiable;
+		for (size_t i = 0; i < 5; ++i) {
+			noncopiable.PushBack(X(i));
+		}
+		noncopiable.Erase(noncopiable.begin(), noncopiable.begin() + 2);
+		assert(noncopiable.GetSize() == 3 && noncopiable[0].GetX() == 2);
+	}
+	// Assign
+	{
+		SimpleVector<std::string> v{ "a"s, "b"s, "c"s };
+		const size_t old_capacity = v.GetCapacity();
+		v.Assign({ "x"s, "y"s });
+		assert((v == SimpleVector<std::string>{"x"s, "y"s}));
+		assert(v.GetCapacity() == old_capacity);
+		v.Assign(3, "z"s);
+		assert((v == SimpleVector<std::string>{"z"s, "z"s, "z"s}));
+		v.Assign(5, v[0]);
+		assert(v.GetSize() == 5 && v[4] == "z"s);
+
+		const std::string words[] = { "p"s, "q"s, "r"s, "s"s, "t"s, "u"s };
+		v.Assign(std::begin(words), std::end(words));
+		assert(v.GetSize() == 6 && v[5] == "u"s);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestVectorStats() {
+	cout << "Test vector stats" << endl;
+	// Выключенный режим не добавляет к вектору ни байта
+	static_assert(kVectorStatsEnabled || sizeof(SimpleVector<int>) == sizeof(ArrayPtr<int>) + 2 * sizeof(size_t));
+	if constexpr (!kVectorStatsEnabled) {
+		SimpleVector<int> v(5);
+		assert(v.GetStats().allocations == 0);
+	}
+	if constexpr (kVectorStatsEnabled) {
+		ResetThreadVectorStats();
+		// Удвоение: 100 вставок — 8 выделений (1, 2, ..., 128) и 7 освобождений старых блоков
+		{
+			SimpleVector<std::string> v;
+			for (int i = 0; i < 100; ++i) {
+				v.PushBack(std::to_string(i));
+			}
+			const VectorStats& stats = v.GetStats();
+			assert(stats.allocations == 8 && stats.deallocations == 7);
+			assert(stats.growths == 8 && stats.peak_capacity == 128);
+			assert(stats.copies == 0);
+			assert(stats.bytes_allocated == 255 * sizeof(std::string));
+		}
+		// Резерв заранее — одно выделение на всю серию вставок
+		{
+			SimpleVector<int> v(Reserve(100));
+			const VectorStats before = v.GetStats();
+			for (int i = 0; i < 100; ++i) {
+				v.PushBack(i);
+			}
+			const VectorStats delta = v.GetStats() - before;
+			assert(delta.allocations == 0 && delta.growths == 0);
+			assert(before.allocations == 1);
+		}
+		// Копирование строк учитывается как копирование, вставка rvalue — как перемещение
+		{
+			SimpleVector<std::string> source{ "a"s, "b"s, "c"s };
+			SimpleVector<std::string> copy(source);
+			assert(copy.GetStats().copies == 3 && copy.GetStats().allocations == 1);
+			SimpleVector<std::string> target;
+			target = copy;
+			assert(target.GetStats().copies == 3 && target.GetStats().allocations == 1);
+			target.Insert(target.begin(), "z"s);
+			assert(target.GetStats().moves > 0);
+		}
+		// Тривиальный тип переносится побайтово
+		{
+			SimpleVector<int> v{ 1, 2, 3, 4 };
+			v.PushBack(5);
+			assert(v.GetStats().bytes_relocated == 4 * sizeof(int));
+		}
+		// Сводные счётчики потока видят все векторы, включая уже разрушенные
+		const VectorStats& total = ThreadVectorStats();
+		assert(total.allocations == total.deallocations);
+		assert(total.allocations >= 8 + 1 + 2 + 2);
+		std::ostringstream out;
+		DumpThreadVectorStats(out);
+		assert(out.str().find("\"allocations\": ") != std::string::npos);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestMmapAllocator() {
+	cout << "Test mmap allocator" << endl;
+	{
+		SimpleVector<int, MmapAllocator<int>> v;
+		for (int i = 0; i < 1'000'000; ++i) {
+			v.PushBack(i);
+		}
+		assert(v.GetSize() == 1'000'000);
+		assert(v[0] == 0 && v[999'999] == 999'999);
+		// Блок берётся у ОС целыми страницами
+		assert(reinterpret_cast<uintptr_t>(v.begin()) % MmapAllocator<int>::PageSize() == 0);
+
+		v.Resize(10);
+		v.ShrinkToFit();
+		assert(v.GetCapacity() == 10);
+		assert(v[9] == 9);
+	}
+	// Большие страницы и нетривиальные элементы, которые переносятся поэлементно
+	{
+		SimpleVector<double, MmapAllocator<double, true>> numbers(Reserve(1 << 20));
+		numbers.Append(1 << 21, 1.5);
+		assert(numbers.GetSize() == (1 << 21) && numbers[(1 << 21) - 1] == 1.5);
+
+		SimpleVector<std::string, MmapAllocator<std::string>> words;
+		for (int i = 0; i < 1000; ++i) {
+			words.PushBack(std::to_string(i));
+		}
+		SimpleVector<std::string, MmapAllocator<std::string>> copy(words);
+		assert(copy == words && copy[999] == "999"s);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestMappedVector() {
+	cout << "Test mapped vector" << endl;
+	const std::string path = (std::filesystem::temp_directory_path() / "simple_vector_mapped_test.bin").string();
+	{
+		auto v = MappedSimpleVector<int>::Create(path);
+		for (int i = 0; i < 10'000; ++i) {
+			v.PushBack(i);
+		}
+		v.Resize(12'000, -1);
+		assert(v.GetSize() == 12'000 && v[11'999] == -1);
+		v.PushBack(v[0]);
+		v.Flush();
+	}
+	// Открытие без разбора: данные те же, вектор можно продолжать наполнять
+	{
+		auto v = MappedSimpleVector<int>::Open(path);
+		assert(v.GetSize() == 12'001);
+		assert(v[9'999] == 9'999 && v[12'000] == 0);
+		v.PopBack();
+		v.PushBack(42);
+	}
+	// Только чтение: изменения запрещены
+	{
+		const auto v = MappedSimpleVector<int>::Open(path, MapMode::kReadOnly);
+		assert(v.GetSize() == 12'001 && v[12'000] == 42);
+		auto writable = MappedSimpleVector<int>::Open(path, MapMode::kReadOnly);
+		try {
+			writable.PushBack(1);
+			assert(false);
+		}
+		catch (const std::logic_error&) {
+		}
+		// Неконстантные методы доступа тоже отказывают, а не отдают ссылку в защищённую от записи память
+		const auto expect_logic_error = [](auto access) {
+			try {
+				access();
+				assert(false);
+			}
+			catch (const std::logic_error&) {
+			}
+		};
+		expect_logic_error([&writable] {
+			writable[0] = 1;
+		});
+		expect_logic_error([&writable] {
+			writable.At(0) = 1;
+		});
+		expect_logic_error([&writable] {
+			*writable.begin() = 1;
+		});
+		expect_logic_error([&writable] {
+			writable.end();
+		});
+		const auto& readable = writable;
+		assert(readable[0] == 0 && readable.At(12'000) == 42 && *readable.begin() == 0);
+	}
+	// Копирование при записи: изменения и рост не попадают в файл
+	{
+		auto v = MappedSimpleVector<int>::Open(path, MapMode::kCopyOnWrite);
+		v[0] = 100;
+		v.Resize(50'000, 7);
+		assert(v[0] == 100 && v[49'999] == 7);
+
+		const auto original = MappedSimpleVector<int>::Open(path, MapMode::kReadOnly);
+		assert(original.GetSize() == 12'001 && original[0] == 0);
+	}
+	// Файл другого типа не открывается
+	try {
+		MappedSimpleVector<double>::Open(path);
+		assert(false);
+	}
+	catch (const std::runtime_error&) {
+	}
+	std::filesystem::remove(path);
+	cout << "Done!" << endl << endl;
+}
+
+// Пример пользовательского кодека для нетривиального типа
+struct NamedValue {
+	std::string name;
+	int value = 0;
+};
+
+struct NamedValueCodec {
+	static void Write(std::ostream& out, const NamedValue& item) {
+		BinaryCodec<std::string>::Write(out, item.name);
+		out.write(reinterpret_cast<const char*>(&item.value), sizeof(item.value));
+	}
+
+	static NamedValue Read(std::istream& in) {
+		NamedValue item;
+		item.name = BinaryCodec<std::string>::Read(in);
+		in.read(reinterpret_cast<char*>(&item.value), sizeof(item.value));
+		return item;
+	}
+};
+
+void TestBinaryIO() {
+	cout << "Test binary io" << endl;
+	// Тривиальный тип: весь буфер одним блоком
+	{
+		SimpleVector<double> v;
+		for (int i = 0; i < 100'000; ++i) {
+			v.PushBack(i * 0.5);
+		}
+		std::stringstream buffer;
+		Save(buffer, v);
+		SimpleVector<double> loaded{ 1.0 };
+		Load(buffer, loaded);
+		assert(loaded == v);
+	}
+	// Строки и пользовательский кодек
+	{
+		SimpleVector<std::string> words{ "alpha"s, ""s, "gamma"s };
+		std::stringstream buffer;
+		Save(buffer, words);
+		SimpleVector<std::string> loaded;
+		Load(buffer, loaded);
+		assert(loaded == words);
+
+		SimpleVector<NamedValue> items;
+		items.PushBack({ "x"s, 1 });
+		items.PushBack({ "y"s, 2 });
+		std::stringstream items_buffer;
+		Save<NamedValueCodec>(items_buffer, items);
+		SimpleVector<NamedValue> loaded_items;
+		Load<NamedValueCodec>(items_buffer, loaded_items);
+		assert(loaded_items.GetSize() == 2 && loaded_items[1].name == "y"s && loaded_items[1].value == 2);
+	}
+	// Потоковая запись блоками и чтение порциями в один и тот же вектор
+	{
+		std::stringstream buffer;
+		{
+			SimpleVectorWriter<int> writer(buffer);
+			SimpleVector<int> block;
+			for (int b = 0; b < 10; ++b) {
+				block.Clear();
+				for (int i = 0; i < 1000; ++i) {
+					block.PushBack(b * 1000 + i);
+				}
+				writer.Write(block);
+			}
+		}
+		SimpleVectorReader<int> reader(buffer);
+		SimpleVector<int> chunk;
+		long long sum = 0;
+		size_t chunks = 0;
+		int expected = 0;
+		while (reader.ReadChunk(chunk, 768)) {
+			assert(chunk.GetSize() <= 768);
+			assert(chunk[0] == expected);
+			expected += static_cast<int>(chunk.GetSize());
+			sum = std::accumulate(chunk.begin(), chunk.end(), sum);
+			++chunks;
+		}
+		assert(expected == 10'000 && chunks == (10'000 + 767) / 768);
+		assert(sum == 9'999LL * 10'000 / 2);
+		assert(chunk.GetCapacity() <= 1024);
+	}
+	// Повреждённые данные: исключение, исходный вектор не меняется
+	{
+		SimpleVector<int> v{ 1, 2, 3 };
+		std::stringstream buffer;
+		Save(buffer, v);
+		std::string truncated = buffer.str();
+		truncated.resize(truncated.size() - 10);
+		std::istringstream input(truncated);
+		SimpleVector<int> target{ 7 };
+		try {
+			Load(input, target);
+			assert(false);
+		}
+		catch (const std::runtime_error&) {
+		}
+		assert((target == SimpleVector<int>{7}));
+
+		// Оборванное чтение в хвост не меняет размер вектора
+		std::istringstream short_input(truncated);
+		SimpleVectorReader<int> reader(short_input);
+		SimpleVector<int> partial{ 5 };
+		try {
+			reader.ReadInto(partial);
+			assert(false);
+		}
+		catch (const std::runtime_error&) {
+		}
+		assert((partial == SimpleVector<int>{5}));
+
+		std::istringstream wrong_type(buffer.str());
+		SimpleVector<double> doubles;
+		try {
+			Load(wrong_type, doubles);
+			assert(false);
+		}
+		catch (const std::runtime_error&) {
+		}
+	}
+	cout << "Done!" << endl << endl;
+}
+
+// Сравнивает результат операторов с поэлементными алгоритмами на парах, различающихся в одной позиции
+template <typename Type>
+void CheckComparisonsAgainstStd(Type base, Type other) {
+	for (size_t size = 0; size < 70; ++size) {
+		for (size_t pos = 0; pos <= size; ++pos) {
+			SimpleVector<Type> lhs(size, base);
+			SimpleVector<Type> rhs(size, base);
+			if (pos < size) {
+				rhs[pos] = other;
+			}
+			for (int swap_sides = 0; swap_sides < 2; ++swap_sides) {
+				assert((lhs == rhs) == std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+				assert((lhs < rhs) == std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+				assert((lhs != rhs) == !std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+				assert((lhs > rhs) == std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end()));
+				assert((lhs <= rhs) == !std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end()));
+				assert((lhs >= rhs) == !std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+				lhs.swap(rhs);
+			}
+			// Разная длина при общем префиксе
+			rhs.PushBack(base);
+			assert((lhs < rhs) == std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()));
+			assert((rhs < lhs) == std::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end()));
+			assert(!(lhs == rhs));
+		}
+	}
+}
+
+void TestSimdComparisons() {
+	cout << "Test simd comparisons" << endl;
+	CheckComparisonsAgainstStd<int>(5, -7);
+	CheckComparisonsAgainstStd<char>('a', static_cast<char>(-3));
+	CheckComparisonsAgainstStd<unsigned short>(0x0100, 0x00FF);
+	CheckComparisonsAgainstStd<long long>(1LL << 40, 1);
+	CheckComparisonsAgainstStd<float>(1.5f, -2.0f);
+	CheckComparisonsAgainstStd<double>(1.5, 3.0);
+
+	// NaN не равен ничему, включая себя, но в лексикографическом сравнении эквивалентен любому значению
+	const double nan = std::numeric_limits<double>::quiet_NaN();
+	CheckComparisonsAgainstStd<double>(1.0, nan);
+	CheckComparisonsAgainstStd<float>(std::numeric_limits<float>::quiet_NaN(), 2.0f);
+	{
+		SimpleVector<double> lhs(40, 1.0);
+		lhs[10] = nan;
+		SimpleVector<double> rhs(lhs);
+		assert(lhs != rhs);
+		assert(!(lhs < rhs) && !(rhs < lhs));
+		rhs[30] = 2.0;
+		assert(lhs < rhs);
+	}
+	// +0.0 и -0.0 равны, хотя их байты различаются
+	{
+		SimpleVector<float> lhs(33, 0.0f);
+		SimpleVector<float> rhs(33, -0.0f);
+		assert(lhs == rhs);
+		assert(!(lhs < rhs) && !(rhs < lhs));
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestFastFill() {
+	cout << "Test fast fill" << endl;
+	// Конструкторы и Resize заполняют только новые элементы
+	{
+		SimpleVector<int> v(1000, 7);
+		assert(std::all_of(v.begin(), v.end(), [](int x) {
+			return x == 7;
+		}));
+		v.Resize(3000);
+		assert(v[999] == 7 && v[1000] == 0 && v[2999] == 0);
+		v.Append(5, -1);
+		assert(v.GetSize() == 3005 && v[3004] == -1);
+
+		SimpleVector<double> d(100, 0.25);
+		d.Resize(200);
+		assert(d[99] == 0.25 && d[199] == 0.0);
+	}
+	// Потоковые записи и деление между потоками на маленьких порогах, с невыровненным началом
+	{
+		std::vector<std::uint16_t> buffer(100'003, 1);
+		fast_fill::Fill(buffer.data() + 1, buffer.size() - 2, std::uint16_t{ 0xABCD }, 4096, 64);
+		assert(buffer.front() == 1 && buffer.back() == 1);
+		assert(std::all_of(buffer.begin() + 1, buffer.end() - 1, [](std::uint16_t x) {
+			return x == 0xABCD;
+		}));
+
+		std::vector<double> doubles(50'001, 1.0);
+		fast_fill::Fill(doubles.data(), doubles.size(), -0.0, 1024, 1024);
+		assert(std::all_of(doubles.begin(), doubles.end(), [](double x) {
+			return x == 0.0 && std::signbit(x);
+		}));
+		fast_fill::Fill(doubles.data(), doubles.size(), 0.0, 1024, 1024);
+		assert(!std::signbit(doubles[50'000]));
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestParallelAlgorithms() {
+	cout << "Test parallel algorithms" << endl;
+	// Отдельный пул, чтобы задачи действительно выполнялись в нескольких потоках даже на одном ядре
+	WorkStealingPool pool(4);
+	ParallelOptions options;
+	options.pool = &pool;
+	options.grain = 1000;
+	options.serial_threshold = 1000;
+
+	const size_t size = 100'003;
+	SimpleVector<long long> v(size);
+	std::iota(v.begin(), v.end(), 1);
+
+	ParallelForEach(v, [](long long& x) {
+		x *= 2;
+	}, options);
+	assert(v[0] == 2 && v[size - 1] == 2 * static_cast<long long>(size));
+
+	SimpleVector<double> halves;
+	ParallelTransform(v, halves, [](long long x) {
+		return x / 2.0;
+	}, options);
+	assert(halves.GetSize() == size && halves[size - 1] == static_cast<double>(size));
+
+	const long long n = static_cast<long long>(size);
+	assert(ParallelReduce(v, 0LL, options) == n * (n + 1));
+	// Ассоциативная, но некоммутативная операция: порядок порций сохраняется
+	SimpleVector<std::string> letters;
+	for (size_t i = 0; i < 5000; ++i) {
+		letters.PushBack(std::string(1, static_cast<char>('a' + i % 26)));
+	}
+	const std::string joined = ParallelReduce(letters, ""s, std::plus<>(), options);
+	assert(joined == std::accumulate(letters.begin(), letters.end(), ""s));
+
+	SimpleVector<long long> prefix(v);
+	ParallelInclusiveScan(prefix, std::plus<>(), options);
+	SimpleVector<long long> expected(size);
+	std::partial_sum(v.begin(), v.end(), expected.begin());
+	assert(prefix == expected);
+
+	// Короткий диапазон и общий пул
+	SimpleVector<int> small{ 1, 2, 3 };
+	ParallelInclusiveScan(small);
+	assert((small == SimpleVector<int>{1, 3, 6}));
+	assert(ParallelReduce(small, 0) == 10);
+
+	// Исключение из задачи доходит до вызывающего потока
+	try {
+		ParallelForEach(v, [](long long x) {
+			if (x == 2 * 77'777) {
+				throw std::runtime_error("stop");
+			}
+		}, options);
+		assert(false);
+	}
+	catch (const std::runtime_error&) {
+	}
+
+	// Вложенный параллелизм не блокирует пул
+	std::atomic<size_t> inner_calls{ 0 };
+	SimpleVector<int> outer(8, 0);
+	ParallelForEach(outer, [&](int&) {
+		ParallelOptions inner = options;
+		inner.grain = 100;
+		ParallelForEach(v.begin(), v.begin() + 10'000, [&](long long) {
+			inner_calls.fetch_add(1, std::memory_order_relaxed);
+		}, inner);
+	}, ParallelOptions{ 1, 1, &pool });
+	assert(inner_calls == 80'000);
+	cout << "Done!" << endl << endl;
+}
+
+void TestConcurrentVector() {
+	cout << "Test concurrent vector" << endl;
+	{
+		ConcurrentSimpleVector<std::string> v;
+		v.PushBack("a"s);
+		std::string& b = v.EmplaceBack(3, 'b');
+		assert(v.GetSize() == 2 && v[1] == "bbb"s && &b == &v[1]);
+		for (int i = 0; i < 1000; ++i) {
+			v.PushBack(std::to_string(i));
+		}
+		// Элементы не переезжают при росте
+		assert(&b == &v[1] && v.At(1001) == "999"s);
+		size_t count = 0;
+		for (const std::string& s : v) {
+			count += s.empty() ? 0 : 1;
+		}
+		assert(count == 1002);
+	}
+	// Много производителей и читатель опубликованного префикса
+	{
+		constexpr size_t kThreads = 8;
+		constexpr size_t kPerThread = 20'000;
+		ConcurrentSimpleVector<size_t> v;
+		std::atomic<bool> done{ false };
+		std::thread reader([&] {
+			while (!done.load()) {
+				const size_t size = v.GetSize();
+				for (size_t i = 0; i < size; i += 97) {
+					assert(v[i] < kThreads * kPerThread);
+				}
+			}
+		});
+		std::vector<std::thread> producers;
+		for (size_t t = 0; t < kThreads; ++t) {
+			producers.emplace_back([&v, t] {
+				for (size_t i = 0; i < kPerThread; ++i) {
+					v.PushBack(t * kPerThread + i);
+				}
+			});
+		}
+		for (std::thread& producer : producers) {
+			producer.join();
+		}
+		done = true;
+		reader.join();
+
+		assert(v.GetSize() == kThreads * kPerThread);
+		std::vector<bool> seen(kThreads * kPerThread, false);
+		for (size_t value : v) {
+			assert(!seen[value]);
+			seen[value] = true;
+		}
+		assert(v.GetCapacity() >= v.GetSize());
+	}
+	cout << "Done!" << endl << endl;
+}
+
+// Считает живые объекты; конструктор по умолчанию и копирование бросают исключение, когда countdown доходит до нуля
+struct ThrowingCounted {
+	static inline int countdown = -1;
+	static inline int alive = 0;
+
+	ThrowingCounted() {
+		Tick();
+	}
+	ThrowingCounted(const ThrowingCounted&) {
+		Tick();
+	}
+	ThrowingCounted& operator=(const ThrowingCounted&) = default;
+	~ThrowingCounted() {
+		--alive;
+	}
+
+	static void Tick() {
+		if (countdown >= 0 && countdown-- == 0) {
+			throw std::runtime_error("construction failed");
+		}
+		++alive;
+	}
+};
+
+void TestStableVector() {
+	cout << "Test stable vector" << endl;
+	{
+		StableSimpleVector<std::string> v;
+		v.PushBack("first"s);
+		const std::string* first = &v[0];
+		auto first_it = v.begin();
+		for (int i = 0; i < 10'000; ++i) {
+			// Ссылка на собственный элемент остаётся действительной во время роста
+			v.PushBack(v[0]);
+		}
+		assert(v.GetSize() == 10'001);
+		assert(&v[0] == first && &*first_it == first);
+		assert(v.At(10'000) == "first"s);
+		assert(v.GetCapacity() >= v.GetSize() && v.GetCapacity() < 2 * v.GetSize() + 32);
+
+		v.PopBack();
+		v.Resize(5);
+		assert(v.GetSize() == 5 && &v[0] == first);
+		v.Resize(40);
+		assert(v[39].empty());
+	}
+	// Итераторы произвольного доступа и алгоритмы
+	{
+		StableSimpleVector<int> v;
+		for (int i = 0; i < 1000; ++i) {
+			v.PushBack(1000 - i);
+		}
+		std::sort(v.begin(), v.end());
+		assert(std::is_sorted(v.cbegin(), v.cend()));
+		assert(v.end() - v.begin() == 1000 && v.begin()[999] == 1000);
+		assert(std::accumulate(v.begin(), v.end(), 0) == 500'500);
+
+		StableSimpleVector<int> copy(v);
+		assert(copy == v);
+		copy.PushBack(0);
+		assert(v < copy);
+		StableSimpleVector<int> moved(std::move(copy));
+		assert(moved.GetSize() == 1001 && copy.IsEmpty());
+	}
+	// Некопируемые элементы
+	{
+		StableSimpleVector<X> v(Reserve(3));
+		const size_t capacity = v.GetCapacity();
+		for (size_t i = 0; i < capacity; ++i) {
+			v.EmplaceBack(i);
+		}
+		assert(v.GetCapacity() == capacity && v[capacity - 1].GetX() == capacity - 1);
+		StableSimpleVector<X> other;
+		other = std::move(v);
+		assert(other.GetSize() == capacity);
+	}
+	// Исключение из конструктора элемента разрушает уже созданные элементы
+	{
+		const ThrowingCounted sample;
+		const StableSimpleVector<ThrowingCounted> source(100);
+		const int alive = ThrowingCounted::alive;
+		const auto expect_cleanup = [alive](int countdown, auto construct) {
+			ThrowingCounted::countdown = countdown;
+			try {
+				construct();
+				assert(false);
+			}
+			catch (const std::runtime_error&) {
+			}
+			ThrowingCounted::countdown = -1;
+			assert(ThrowingCounted::alive == alive);
+		};
+		expect_cleanup(40, [] {
+			StableSimpleVector<ThrowingCounted> v(100);
+		});
+		expect_cleanup(40, [&sample] {
+			StableSimpleVector<ThrowingCounted> v(100, sample);
+		});
+		// Три копии уходят в initializer_list, второй элемент вектора уже не создаётся
+		expect_cleanup(4, [&sample] {
+			StableSimpleVector<ThrowingCounted> v{ sample, sample, sample };
+		});
+		expect_cleanup(40, [&source] {
+			StableSimpleVector<ThrowingCounted> copy(source);
+		});
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestSharedVector() {
+	cout << "Test shared vector" << endl;
+	{
+		SharedSimpleVector<std::string> v{ "a"s, "b"s, "c"s };
+		const SharedSimpleVector<std::string> snapshot = v;
+		// Копия разделяет содержимое, пока его никто не меняет
+		assert(v.GetUseCount() == 2 && &v.GetVector() == &snapshot.GetVector());
+		assert(&std::as_const(v)[0] == &snapshot[0]);
+
+		v.PushBack(v[0]);
+		assert(v.GetUseCount() == 1 && snapshot.GetUseCount() == 1);
+		assert(v.GetSize() == 4 && v[3] == "a"s);
+		assert(snapshot.GetSize() == 3 && snapshot[2] == "c"s);
+
+		SharedSimpleVector<std::string> second = snapshot;
+		second[1] = "x"s;
+		assert(snapshot[1] == "b"s && second[1] == "x"s);
+
+		second = snapshot;
+		auto it = second.Insert(second.cbegin() + 1, "y"s);
+		assert(*it == "y"s && second.GetSize() == 4 && snapshot.GetSize() == 3);
+		second = snapshot;
+		second.Erase(second.cbegin());
+		assert(second[0] == "b"s && snapshot[0] == "a"s);
+
+		second = snapshot;
+		second.Clear();
+		assert(second.IsEmpty() && snapshot.GetSize() == 3 && snapshot.GetUseCount() == 1);
+
+		second = snapshot;
+		second.Resize(10);
+		assert(second.GetSize() == 10 && snapshot.GetSize() == 3);
+		assert(snapshot < second && snapshot != second);
+		try {
+			second.At(10);
+			assert(false);
+		}
+		catch (const std::out_of_range&) {
+		}
+	}
+	// Отделение заполненного вектора при вставке сразу даёт копии запас по политике роста
+	{
+		SharedSimpleVector<int> full;
+		full.Reserve(8);
+		for (int i = 0; i < 8; ++i) {
+			full.PushBack(i);
+		}
+		const SharedSimpleVector<int> snapshot = full;
+		full.PushBack(8);
+		assert(full.GetCapacity() == 16 && snapshot.GetCapacity() == 8);
+		const int* data = &full[0];
+		full.PushBack(9);
+		assert(&full[0] == data);
+
+		SharedSimpleVector<int> inserted = snapshot;
+		inserted.Insert(inserted.cbegin(), -1);
+		assert(inserted.GetCapacity() == 16 && inserted[0] == -1 && inserted[8] == 7);
+	}
+	// Уменьшение разделённого вектора копирует только оставшиеся элементы
+	{
+		SharedSimpleVector<CountedObj> original(100);
+		const SharedSimpleVector<CountedObj> snapshot = original;
+		CountedObj::Reset();
+		original.Resize(10);
+		assert(CountedObj::constructed == 10 && original.GetSize() == 10 && original.GetCapacity() == 10);
+		assert(snapshot.GetSize() == 100 && snapshot.GetUseCount() == 1);
+		SharedSimpleVector<CountedObj> same = snapshot;
+		same.Resize(100);
+		assert(same.GetUseCount() == 2);
+	}
+	// Снимки читаются в других потоках, пока владелец дописывает свою копию
+	{
+		SharedSimpleVector<int> owner;
+		for (int i = 0; i < 1000; ++i) {
+			owner.PushBack(i);
+		}
+		std::vector<std::thread> readers;
+		for (int t = 0; t < 4; ++t) {
+			readers.emplace_back([snapshot = owner] {
+				assert(std::accumulate(snapshot.begin(), snapshot.end(), 0) == 499'500);
+			});
+		}
+		for (int i = 0; i < 1000; ++i) {
+			owner.PushBack(i);
+		}
+		for (std::thread& reader : readers) {
+			reader.join();
+		}
+		assert(owner.GetSize() == 2000 && owner.GetUseCount() == 1);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestAlignedVector() {
+	cout << "Test aligned vector" << endl;
+	const auto is_aligned = [](const void* ptr, size_t alignment) {
+		return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+	};
+	static_assert(AlignedSimpleVector<double>::kAlignment == 64);
+	static_assert(AlignedSimpleVector<char, 32>::kAlignment == 32);
+	static_assert(SimpleVector<int>::kAlignment == alignof(int));
+	{
+		AlignedSimpleVector<double> v;
+		for (int i = 0; i < 1000; ++i) {
+			v.PushBack(i);
+			assert(is_aligned(v.begin(), 64));
+		}
+		v.Insert(v.begin() + 1, 100, 0.5);
+		v.ShrinkToFit();
+		assert(is_aligned(v.begin(), 64) && v.GetSize() == 1100 && v[1099] == 999);
+		AlignedSimpleVector<double> copy(v);
+		assert(is_aligned(copy.begin(), 64) && copy == v);
+		copy.Resize(3000);
+		assert(is_aligned(copy.begin(), 64));
+	}
+	{
+		AlignedSimpleVector<std::string, 32> v(Reserve(1));
+		v.PushBack("a"s);
+		v.PushBack("b"s);
+		v.EmplaceBack(3, 'c');
+		assert(is_aligned(v.begin(), 32) && v[2] == "ccc"s);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+// Поле, копирование которого бросает исключение по требованию, а перемещение не помечено noexcept
+struct FragileField {
+	static inline bool fail = false;
+
+	FragileField() = default;
+	FragileField(int value)
+		: value(value) {
+	}
+	FragileField(const FragileField& other)
+		: value(other.value) {
+		if (fail) {
+			throw std::runtime_error("copy failed");
+		}
+	}
+	FragileField(FragileField&& other)
+		: value(other.value) {
+	}
+	FragileField& operator=(const FragileField&) = default;
+
+	int value = 0;
+};
+
+void TestSoAVector() {
+	cout << "Test SoA vector" << endl;
+	{
+		SoAVector<float, float, int, std::string> particles;
+		for (int i = 0; i < 100; ++i) {
+			particles.PushBack({ float(i), float(-i), i, std::to_string(i) });
+		}
+		particles.EmplaceBack(0.5f, 1.5f, 100, "last"s);
+		assert(particles.GetSize() == 101 && particles.GetCapacity() >= 101);
+
+		// Столбцы непрерывны и проходятся как обычные массивы
+		auto xs = particles.Column<0>();
+		assert(xs.GetSize() == 101 && xs.Data() + 100 == &std::get<0>(particles[100]));
+		assert(std::accumulate(xs.begin(), xs.end() - 1, 0.0f) == 4950.0f);
+		for (float& y : particles.Column<1>()) {
+			y = -y;
+		}
+
+		// Строка — кортеж ссылок на поля
+		auto [x, y, id, name] = particles[42];
+		assert(x == 42.0f && y == 42.0f && id == 42 && name == "42"s);
+		name = "answer"s;
+		assert(std::get<3>(particles.At(42)) == "answer"s);
+
+		int ids = 0;
+		for (auto [px, py, pid, pname] : std::as_const(particles)) {
+			ids += pid;
+		}
+		assert(ids == 5050);
+		assert(std::count_if(particles.begin(), particles.end(), [](const auto& row) {
+			return std::get<2>(row) % 2 == 0;
+		}) == 51);
+		assert(particles.end() - particles.begin() == 101 && std::get<2>(particles.cbegin()[7]) == 7);
+
+		SoAVector<float, float, int, std::string> copy(particles);
+		assert(copy == particles);
+		copy.PopBack();
+		assert(copy != particles);
+		copy.Resize(200);
+		assert(copy.GetSize() == 200 && std::get<3>(copy[199]).empty());
+		copy.Clear();
+		assert(copy.IsEmpty());
+		copy = std::move(particles);
+		assert(copy.GetSize() == 101 && particles.IsEmpty());
+		try {
+			copy.At(101);
+			assert(false);
+		}
+		catch (const std::out_of_range&) {
+		}
+	}
+	// Аргументы EmplaceBack могут ссылаться на собственные поля во время роста
+	{
+		SoAVector<std::string, int> v;
+		v.EmplaceBack("self"s, 1);
+		for (int i = 0; i < 100; ++i) {
+			v.EmplaceBack(std::get<0>(v[0]), std::get<1>(v[i]) + 1);
+		}
+		assert(std::get<0>(v[100]) == "self"s && std::get<1>(v[100]) == 101);
+	}
+	// Если не удаётся скопировать столбец при росте, контейнер не меняется
+	{
+		SoAVector<std::string, FragileField> v;
+		v.Reserve(2);
+		v.EmplaceBack("a"s, 1);
+		v.EmplaceBack("b"s, 2);
+		FragileField::fail = true;
+		try {
+			v.Reserve(10);
+			assert(false);
+		}
+		catch (const std::runtime_error&) {
+		}
+		FragileField::fail = false;
+		assert(v.GetCapacity() == 2 && std::get<0>(v[1]) == "b"s && std::get<1>(v[1]).value == 2);
+		v.Reserve(10);
+		assert(v.GetCapacity() == 10 && std::get<0>(v[0]) == "a"s);
+	}
+	// Исключение из конструктора поля разрушает уже созданные строки
+	{
+		const int alive = ThrowingCounted::alive;
+		ThrowingCounted::countdown = 40;
+		try {
+			SoAVector<std::string, ThrowingCounted> v(100);
+			assert(false);
+		}
+		catch (const std::runtime_error&) {
+		}
+		ThrowingCounted::countdown = -1;
+		assert(ThrowingCounted::alive == alive);
+	}
+	cout << "Done!" << endl << endl;
+}
+
+void TestFlatContainers() {
+	cout << "Test flat containers" << endl;
+	{
+		FlatSet<int> set{ 5, 1, 3, 1, 9 };
+		assert(set.GetSize() == 4 && std::is_sorted(set.begin(), set.end()));
+		assert(set.Contains(3) && !set.Contains(4) && set.Count(9) == 1);
+		assert(*set.LowerBound(4) == 5 && *set.UpperBound(5) == 9 && set.LowerBound(10) == set.end());
+
+		assert(set.Insert(4).second && !set.Insert(4).second);
+		assert(set.Erase(1) == 1 && set.Erase(1) == 0);
+		set.InsertRange({ 8, 2, 9, 2, 0 });
+		const std::vector<int> expected{ 0, 2, 3, 4, 5, 8, 9 };
+		assert(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+
+		// Поиск согласован с std::lower_bound на разных размерах
+		FlatSet<int> evens;
+		std::vector<int> values;
+		for (int i = 0; i < 1000; ++i) {
+			values.push_back(2 * i);
+		}
+		std::reverse(values.begin(), values.end());
+		evens.InsertRange(values.begin(), values.end());
+		for (int key = -1; key <= 2001; ++key) {
+			assert(std::lower_bound(evens.begin(), evens.end(), key) == evens.LowerBound(key));
+			assert(std::upper_bound(evens.begin(), evens.end(), key) == evens.UpperBound(key));
+			assert(evens.Contains(key) == (key >= 0 && key % 2 == 0 && key < 2000));
+		}
+		evens.Reserve(5000);
+		evens.ShrinkToFit();
+		assert(evens.GetCapacity() == 1000);
+
+		FlatSet<std::string, std::greater<>> words{ "b"s, "c"s, "a"s };
+		assert(*words.begin() == "c"s);
+	}
+	{
+		FlatMap<std::string, int> map{ { "one"s, 1 }, { "two"s, 2 } };
+		assert(map.At("two"s) == 2 && map.Find("three"s) == map.end());
+		map["three"s] = 3;
+		++map["one"s];
+		assert(map.GetSize() == 3 && map.At("one"s) == 2);
+		assert(!map.Insert({ "two"s, 20 }).second && map.At("two"s) == 2);
+		assert(!map.InsertOrAssign("two"s, 20).second && map.At("two"s) == 20);
+		// Существующий ключ и первый из повторов в диапазоне побеждают
+		const std::vector<std::pair<std::string, int>> batch{ { "zero"s, 0 }, { "one"s, 100 }, { "four"s, 4 }, { "zero"s, -1 } };
+		map.InsertRange(batch.begin(), batch.end());
+		assert(map.GetSize() == 5 && map.At("one"s) == 2 && map.At("zero"s) == 0);
+		const std::vector<std::string> keys{ "four"s, "one"s, "three"s, "two"s, "zero"s };
+		assert(std::equal(map.begin(), map.end(), keys.begin(), keys.end(), [](const auto& item, const std::string& key) {
+			return item.first == key;
+		}));
+		try {
+			map.At("five"s);
+			assert(false);
+		}
+		catch (const std::out_of_range&) {
+		}
+		map.Erase(map.Find("four"s));
+		assert(map.GetSize() == 4 && !map.Contains("four"s));
+	}
+	cout << "Done!" << endl << endl;
+}
+
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+// Таблица, построенная SimpleVector при компиляции: вставки в начало, удаления, рост и сравнение
+constexpr std::array<int, 8> MakeConstexprTable() {
+	SimpleVector<int> v;
+	for (int i = 0; i < 8; ++i) {
+		v.Insert(v.begin(), i * i);
+	}
+	v.Erase(v.begin() + 2, v.begin() + 4);
+	v.PushBack(-1);
+	v.Resize(8);
+	SimpleVector<int> copy = v;
+	copy.Erase(copy.begin());
+	copy.EmplaceBack(100);
+	std::array<int, 8> table{};
+	std::copy(copy.begin(), copy.end(), table.begin());
+	table[7] = copy < v ? 1 : 0;
+	return table;
+}
+
+constexpr size_t CountConstexprStrings() {
+	SimpleVector<std::string> words{ "b", "c" };
+	words.Insert(words.begin(), "a");
+	words.Append(2, "d");
+	words.PopBack();
+	SimpleVector<std::string> other(words);
+	other.Reserve(16);
+	return words == other && words[0] == "a" ? words.GetSize() : 0;
+}
+#endif
+
+void TestConstexprVector() {
+	cout << "Test constexpr vector" << endl;
+#if SIMPLE_VECTOR_HAS_CONSTEXPR
+	constexpr std::array<int, 8> table = MakeConstexprTable();
+	static_assert(table[0] == 36 && table[1] == 9 && table[2] == 4 && table[5] == -1 && table[6] == 0);
+	static_assert(table[7] == 1);
+	static_assert(CountConstexprStrings() == 4);
+	assert(table[3] == 1);
+#else
+	cout << "constexpr SimpleVector requires C++20" << endl;
+#endif
+	cout << "Done!" << endl << endl;
+}
+
+void TestArenaVector() {
+	cout << "Test arena vector" << endl;
+	Arena arena(1024);
+	{
+		ArenaSimpleVector<int> v(arena);
+		for (int i = 0; i < 100; ++i) {
+			v.PushBack(i);
+		}
+		// Вектор растёт последним в арене, поэтому reallocate расширяет его блок на месте
+		assert(arena.GetBytesUsed() == v.GetCapacity() * sizeof(int));
+		assert(v[99] == 99 && arena.GetChunkAllocations() == 1);
+
+		ArenaSimpleVector<std::string> words(::Reserve(1), arena);
+		for (int i = 0; i < 50; ++i) {
+			words.PushBack(std::to_string(i));
+		}
+		ArenaSimpleVector<std::string> copy(words);
+		assert(copy == words && copy.GetAllocator() == words.GetAllocator());
+		v.Insert(v.begin(), 5, -1);
+		assert(v.GetSize() == 105 && v[0] == -1 && v[5] == 0);
+	}
+	assert(arena.GetChunkAllocations() > 1);
+	// Повторный «запрос» того же объёма после Reset не берёт у системы ни одного куска
+	size_t chunks = 0;
+	for (int request = 0; request < 4; ++request) {
+		arena.Reset();
+		assert(arena.GetBytesUsed() == 0);
+		ArenaSimpleVector<int> v(arena);
+		ArenaSimpleVector<std::string> words(arena);
+		for (int i = 0; i < 100; ++i) {
+			v.PushBack(i);
+			words.PushBack(std::to_string(i));
+		}
+		assert(v[42] == 42 && words[42] == "42"s);
+		if (request == 0) {
+			chunks = arena.GetChunkAllocations();
+		}
+	}
+	assert(arena.GetChunkAllocations() == chunks);
+
+	// Блок больше куска и выравнивание сильнее max_align_t
+	arena.Reset();
+	void* big = arena.Allocate(10'000, 256);
+	assert(reinterpret_cast<std::uintptr_t>(big) % 256 == 0);
+	std::memset(big, 0, 10'000);
+	arena.Release();
+	assert(arena.GetBytesUsed() == 0);
+	cout << "Done!" << endl << endl;
+}
+
+void TestBufferCache() {
+	cout << "Test buffer cache" << endl;
+	BufferCache::Trim();
+	BufferCache::ResetStats();
+	{
+		CachedSimpleVector<int> v;
+		for (int i = 0; i < 100; ++i) {
+			v.PushBack(i);
+		}
+	}
+	// Первый цикл роста обращается к operator new почти за каждым блоком (блок на 4 элемента уже берётся
+	// из класса 16 байт, освобождённого при росте до 2), а все блоки остаются в кэше
+	const BufferCacheStats first = BufferCache::GetStats();
+	assert(first.hits == 1 && first.misses == 7 && first.cached == 8 && first.released == 0);
+	assert(BufferCache::GetCachedBytes() > 0);
+	// Рост через Resize и конструирование с размером получают буферы из кэша
+	{
+		CachedSimpleVector<int> v;
+		v.Resize(100);
+		CachedSimpleVector<int> sized(60, 7);
+		assert(v[99] == 0 && sized[59] == 7);
+	}
+	BufferCacheStats second = BufferCache::GetStats();
+	assert(second.hits == first.hits + 2 && second.misses == first.misses);
+	// Повторный цикл роста вообще не обращается к системному аллокатору
+	{
+		CachedSimpleVector<int> v;
+		for (int i = 0; i < 100; ++i) {
+			v.PushBack(i);
+		}
+	}
+	second = BufferCache::GetStats();
+	assert(second.misses == first.misses);
+	// Строки разного размера попадают в классы по размеру в байтах
+	{
+		CachedSimpleVector<std::string> words;
+		for (int i = 0; i < 20; ++i) {
+			words.PushBack(std::to_string(i));
+		}
+		CachedSimpleVector<std::string> copy(words);
+		assert(copy == words);
+	}
+
+	// Удержание ограничено числом буферов в классе
+	{
+		std::vector<CachedSimpleVector<char>> many(BufferCache::kMaxBuffersPerClass + 3);
+		for (auto& v : many) {
+			v.Reserve(1000);
+		}
+	}
+	second = BufferCache::GetStats();
+	assert(second.released >= 3);
+
+	// Trim отдаёт системе крупные буферы первыми
+	BufferCache::Trim(64);
+	assert(BufferCache::GetCachedBytes() <= 64);
+	BufferCache::Trim();
+	assert(BufferCache::GetCachedBytes() == 0);
+
+	// Буфер, выделенный в одном потоке, кэшируется в том, где вектор уничтожен
+	CachedSimpleVector<int> moved(1000, 1);
+	size_t other_cached = 0;
+	std::thread other([&moved, &other_cached] {
+		{
+			CachedSimpleVector<int> local(std::move(moved));
+		}
+		other_cached = BufferCache::GetStats().cached;
+	});
+	other.join();
+	assert(other_cached == 1 && moved.IsEmpty());
+
+	// Буфер, выделенный после разрушения кэша потока (из деструктора другого thread_local объекта),
+	// всё равно занимает класс целиком: живой кэш выдаёт его под полный размер класса
+	struct LateAllocation {
+		void** out = nullptr;
+		~LateAllocation() {
+			*out = BufferCache::Allocate(20);
+		}
+	};
+	void* late_buffer = nullptr;
+	std::thread exiting([&late_buffer] {
+		// late создаётся раньше кэша потока, поэтому разрушается после него
+		thread_local LateAllocation late;
+		late.out = &late_buffer;
+		BufferCache::GetCachedBytes();
+	});
+	exiting.join();
+	BufferCache::Trim();
+	BufferCache::Deallocate(late_buffer, 20);
+	void* reused = BufferCache::Allocate(32);
+	assert(reused == late_buffer);
+	std::memset(reused, 0, 32);
+	BufferCache::Deallocate(reused, 32);
+	cout << "Done!" << endl << endl;
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing). У каждого рабочего потока своя очередь: свои задачи он берёт
+// с конца (последняя поставленная ещё горячая в кэше), а опустошив её, крадёт самые старые задачи из начала
+// чужих очередей. Задачи, поставленные из рабочего потока, попадают в его очередь, остальные раздаются по кругу.
+// Задачи не должны выбрасывать исключений: алгоритмы parallel_algorithms.h перехватывают их сами
+class WorkStealingPool {
+public:
+	using Task = std::function<void()>;
+
+	// Создаёт пул из thread_count рабочих потоков. Пул без потоков выполняет всё в вызывающем потоке
+	explicit WorkStealingPool(size_t thread_count)
+		: queues_(thread_count) {
+		for (auto& queue : queues_) {
+			queue = std::make_unique<Queue>();
+		}
+		workers_.reserve(thread_count);
+		try {
+			for (size_t i = 0; i < thread_count; ++i) {
+				workers_.emplace_back([this, i] {
+					WorkerLoop(i);
+				});
+			}
+		}
+		catch (...) {
+			Stop();
+			throw;
+		}
+	}
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	// Дожидается завершения уже поставленных задач и останавливает потоки
+	~WorkStealingPool() {
+		Stop();
+	}
+
+	// Общий пул процесса: по рабочему потоку на каждое ядро, кроме ядра вызывающего потока,
+	// который во время параллельного алгоритма работает наравне с пулом
+	static WorkStealingPool& Default() {
+		static WorkStealingPool pool(std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1);
+		return pool;
+	}
+
+	size_t GetThreadCount() const noexcept {
+		return workers_.size();
+	}
+
+	// Ставит задачу в очередь
+	void Submit(Task task) {
+		if (queues_.empty()) {
+			task();
+			return;
+		}
+		const size_t index = current_pool_ == this ? current_index_ : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+		// Счётчик увеличивается раньше, чем задача появится в очереди, чтобы взявший её поток не увёл его ниже нуля
+		{
+			std::lock_guard guard(sleep_mutex_);
+			++pending_;
+		}
+		try {
+			std::lock_guard guard(queues_[index]->mutex);
+			queues_[index]->tasks.push_back(std::move(task));
+		}
+		catch (...) {
+			std::lock_guard guard(sleep_mutex_);
+			--pending_;
+			throw;
+		}
+		wake_up_.notify_one();
+	}
+
+	// Выполняет одну ожидающую задачу в текущем потоке. Возвращает false, если задач нет.
+	// Ожидающий результата поток помогает пулу, а не простаивает, поэтому вложенный параллелизм не блокируется
+	bool RunPendingTask() {
+		Task task;
+		if (!TakeTask(current_pool_ == this ? current_index_ : 0, task)) {
+			return false;
+		}
+		task();
+		return true;
+	}
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue>> queues_;
+	std::vector<std::thread> workers_;
+	std::atomic<size_t> next_queue_{ 0 };
+
+	std::mutex sleep_mutex_;
+	std::condition_variable wake_up_;
+	size_t pending_ = 0;
+	bool stopping_ = false;
+
+	// Пул и очередь рабочего потока, в котором выполняется код
+	static inline thread_local WorkStealingPool* current_pool_ = nullptr;
+	static inline thread_local size_t current_index_ = 0;
+
+	// Берёт задачу из своей очереди с конца, иначе крадёт из начала чужих
+	bool TakeTask(size_t own, Task& task) {
+		if (queues_.empty()) {
+			return false;
+		}
+		for (size_t offset = 0; offset < queues_.size(); ++offset) {
+			Queue& queue = *queues_[(own + offset) % queues_.size()];
+			std::lock_guard guard(queue.mutex);
+			if (queue.tasks.empty()) {
+				continue;
+			}
+			if (offset == 0) {
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else {
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+			std::lock_guard sleep_guard(sleep_mutex_);
+			--pending_;
+			return true;
+		}
+		return false;
+	}
+
+	void WorkerLoop(size_t index) {
+		current_pool_ = this;
+		current_index_ = index;
+		Task task;
+		while (true) {
+			if (TakeTask(index, task)) {
+				task();
+				task = nullptr;
+				continue;
+			}
+			std::unique_lock lock(sleep_mutex_);
+			wake_up_.wait(lock, [this] {
+				return stopping_ || pending_ > 0;
+			});
+			if (stopping_ && pending_ == 0) {
+				return;
+			}
+		}
+	}
+
+	void Stop() noexcept {
+		{
+			std::lock_guard guard(sleep_mutex_);
+			stopping_ = true;
+		}
+		wake_up_.notify_all();
+		for (std::thread& worker : workers_) {
+			worker.join();
+		}
+		workers_.clear();
+	}
+};
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "constexpr_support.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <ostream>
+
+// Счётчики работы SimpleVector с памятью и элементами. Собираются, только если при компиляции
+// определён макрос SIMPLE_VECTOR_STATS; без него все точки записи пустые и не стоят ничего
+struct VectorStats {
+	size_t allocations = 0;
+	size_t deallocations = 0;
+	size_t bytes_allocated = 0;
+	size_t copies = 0;
+	size_t moves = 0;
+	size_t bytes_relocated = 0;
+	size_t growths = 0;
+	size_t peak_capacity = 0;
+
+	constexpr VectorStats& operator+=(const VectorStats& other) noexcept {
+		allocations += other.allocations;
+		deallocations += other.deallocations;
+		bytes_allocated += other.bytes_allocated;
+		copies += other.copies;
+		moves += other.moves;
+		bytes_relocated += other.bytes_relocated;
+		growths += other.growths;
+		peak_capacity = std::max(peak_capacity, other.peak_capacity);
+		return *this;
+	}
+
+	// Выводит счётчики одной строкой в формате JSON
+	void Dump(std::ostream& out) const {
+		out << "{\"allocations\": " << allocations << ", \"deallocations\": " << deallocations
+			<< ", \"bytes_allocated\": " << bytes_allocated << ", \"copies\": " << copies << ", \"moves\": " << moves
+			<< ", \"bytes_relocated\": " << bytes_relocated << ", \"growths\": " << growths
+			<< ", \"peak_capacity\": " << peak_capacity << "}";
+	}
+};
+
+// Разница счётчиков «после» и «до» операции. Пиковая вместимость берётся из after
+inline VectorStats operator-(const VectorStats& after, const VectorStats& before) noexcept {
+	VectorStats delta;
+	delta.allocations = after.allocations - before.allocations;
+	delta.deallocations = after.deallocations - before.deallocations;
+	delta.bytes_allocated = after.bytes_allocated - before.bytes_allocated;
+	delta.copies = after.copies - before.copies;
+	delta.moves = after.moves - before.moves;
+	delta.bytes_relocated = after.bytes_relocated - before.bytes_relocated;
+	delta.growths = after.growths - before.growths;
+	delta.peak_capacity = after.peak_capacity;
+	return delta;
+}
+
+#ifdef SIMPLE_VECTOR_STATS
+inline constexpr bool kVectorStatsEnabled = true;
+#else
+inline constexpr bool kVectorStatsEnabled = false;
+#endif
+
+// Сводные счётчики всех векторов текущего потока. Выделения и освобождения считает ArrayPtr,
+// остальное — SimpleVector
+inline VectorStats& ThreadVectorStats() noexcept {
+	thread_local VectorStats stats;
+	return stats;
+}
+
+inline void ResetThreadVectorStats() noexcept {
+	ThreadVectorStats() = VectorStats();
+}
+
+inline void DumpThreadVectorStats(std::ostream& out) {
+	ThreadVectorStats().Dump(out);
+}
+
+// Счётчики одного вектора. SimpleVector наследует его закрыто, поэтому в выключенном режиме
+// пустая база не занимает места (EBO), а пустые inline-методы исчезают при компиляции.
+// При вычислении на этапе компиляции ведутся только счётчики самого вектора
+class VectorStatsRecorder {
+public:
+#ifdef SIMPLE_VECTOR_STATS
+	const VectorStats& GetStats() const noexcept {
+		return stats_;
+	}
+
+protected:
+	SIMPLE_VECTOR_CONSTEXPR void RecordAllocation(size_t bytes) noexcept {
+		++stats_.allocations;
+		stats_.bytes_allocated += bytes;
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordDeallocation() noexcept {
+		++stats_.deallocations;
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordCopies(size_t count) noexcept {
+		stats_.copies += count;
+		if (!IsConstantEvaluated()) {
+			ThreadVectorStats().copies += count;
+		}
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordMoves(size_t count) noexcept {
+		stats_.moves += count;
+		if (!IsConstantEvaluated()) {
+			ThreadVectorStats().moves += count;
+		}
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordRelocation(size_t bytes) noexcept {
+		stats_.bytes_relocated += bytes;
+		if (!IsConstantEvaluated()) {
+			ThreadVectorStats().bytes_relocated += bytes;
+		}
+	}
+
+	SIMPLE_VECTOR_CONSTEXPR void RecordCapacity(size_t old_capacity, size_t new_capacity) noexcept {
+		if (new_capacity > old_capacity) {
+			++stats_.growths;
+		}
+		stats_.peak_capacity = std::max(stats_.peak_capacity, new_capacity);
+		if (!IsConstantEvaluated()) {
+			VectorStats& thread_stats = ThreadVectorStats();
+			if (new_capacity > old_capacity) {
+				++thread_stats.growths;
+			}
+			thread_stats.peak_capacity = std::max(thread_stats.peak_capacity, new_capacity);
+		}
+	}
+
+	// Забирает счётчики временного вектора, чья работа выполнялась от имени этого. Сводные уже учтены
+	SIMPLE_VECTOR_CONSTEXPR void AbsorbStats(const VectorStatsRecorder& other) noexcept {
+		stats_ += other.stats_;
+	}
+
+private:
+	VectorStats stats_;
+#else
+	const VectorStats& GetStats() const noexcept {
+		static const VectorStats empty;
+		return empty;
+	}
+
+protected:
+	SIMPLE_VECTOR_CONSTEXPR void RecordAllocation(size_t) noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void RecordDeallocation() noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void RecordCopies(size_t) noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void RecordMoves(size_t) noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void RecordRelocation(size_t) noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void RecordCapacity(size_t, size_t) noexcept {
+	}
+	SIMPLE_VECTOR_CONSTEXPR void AbsorbStats(const VectorStatsRecorder&) noexcept {
+	}
+#endif
+};